@@ -0,0 +1,84 @@
+#ifndef __UTIL_BENCH_H__
+#define __UTIL_BENCH_H__
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+/**
+ * @file
+ * Helpers shared by the benchmarks in bench/
+ */
+
+/**
+ * Get monotonic time.
+ *
+ * @return nanoseconds since an unspecified point
+ */
+static inline uint64_t bench_now() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000000000UL + ts.tv_nsec;
+}
+
+/**
+ * Get CPU time used by the whole process.
+ *
+ * @return nanoseconds of user and system time
+ */
+static inline uint64_t bench_cpu() {
+	struct timespec ts;
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000000000UL + ts.tv_nsec;
+}
+
+/**
+ * Print a result line as "benchmark case: value unit".
+ *
+ * @param name benchmark name
+ * @param variant measured case
+ * @param value measured value
+ * @param unit unit of the value
+ */
+static inline void bench_report(const char* name, const char* variant, double value, const char* unit) {
+	printf("%-16s %-40s %14.2f %s\n", name, variant, value, unit);
+}
+
+/**
+ * Seed of the random sequence, the same on every run so results are comparable
+ */
+#define BENCH_SEED	88172645463325252UL
+
+/**
+ * Advance a xorshift64 state which must not be zero.
+ *
+ * @param state random state
+ * @return next random number
+ */
+static inline uint64_t bench_xorshift(uint64_t* state) {
+	*state ^= *state << 13;
+	*state ^= *state >> 7;
+	*state ^= *state << 17;
+
+	return *state;
+}
+
+static uint64_t bench_seed = BENCH_SEED;
+
+/**
+ * Get the next number of the random sequence of the benchmark, single thread only.
+ *
+ * @return next random number
+ */
+static inline uint64_t bench_random() {
+	return bench_xorshift(&bench_seed);
+}
+
+/**
+ * Keep the compiler from optimizing away a computed value.
+ */
+#define BENCH_USE(value)	__asm__ volatile("" : : "r"(value) : "memory")
+
+#endif /* __UTIL_BENCH_H__ */
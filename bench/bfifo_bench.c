@@ -0,0 +1,107 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <sched.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "fifo.h"
+#include "bfifo.h"
+#include "bench.h"
+
+#define ROUNDS		100000
+#define IDLE		500000000L	// ns
+
+static BlockingFIFO* ping;
+static BlockingFIFO* pong;
+
+static void* echo(void* arg) {
+	for(int i = 0; i < ROUNDS; i++)
+		bfifo_push_wait(pong, bfifo_pop_wait(ping, -1), -1);
+
+	return NULL;
+}
+
+// Round trips between two threads, half of one is the wake-up latency of a handoff
+static void latency(const char* variant, int64_t spin) {
+	ping = bfifo_create(16, NULL);
+	pong = bfifo_create(16, NULL);
+	if(spin >= 0) {
+		bfifo_set_spin(ping, spin);
+		bfifo_set_spin(pong, spin);
+	}
+
+	pthread_t thread;
+	pthread_create(&thread, NULL, echo, NULL);
+
+	uint64_t start = bench_now();
+	for(uintptr_t i = 1; i <= ROUNDS; i++) {
+		bfifo_push_wait(ping, (void*)i, -1);
+		bfifo_pop_wait(pong, -1);
+	}
+	uint64_t time = bench_now() - start;
+	pthread_join(thread, NULL);
+
+	bench_report("bfifo", variant, (double)time / ROUNDS / 2, "ns/handoff");
+
+	bfifo_destroy(ping);
+	bfifo_destroy(pong);
+}
+
+static FIFO* fifo;
+static BlockingFIFO* bfifo;
+static volatile bool idle;
+
+static void* wait_bfifo(void* arg) {
+	bfifo_pop_wait(bfifo, IDLE);
+	return NULL;
+}
+
+static void* poll_spin(void* arg) {
+	while(idle && fifo_empty(fifo))
+		__asm__ volatile("" ::: "memory");
+	return NULL;
+}
+
+static void* poll_yield(void* arg) {
+	while(idle && fifo_empty(fifo))
+		sched_yield();
+	return NULL;
+}
+
+static void* poll_sleep(void* arg) {
+	while(idle && fifo_empty(fifo))
+		usleep(100);
+	return NULL;
+}
+
+// CPU time a consumer burns while nothing arrives
+static void idle_cpu(const char* variant, void*(*consumer)(void*)) {
+	idle = true;
+	uint64_t cpu = bench_cpu();
+
+	pthread_t thread;
+	pthread_create(&thread, NULL, consumer, NULL);
+	if(consumer != wait_bfifo) {
+		usleep(IDLE / 1000);
+		idle = false;
+	}
+	pthread_join(thread, NULL);
+
+	bench_report("bfifo idle", variant, (double)(bench_cpu() - cpu) / 1000000, "ms cpu/500ms");
+}
+
+int main(int argc, char** argv) {
+	latency("handoff, default spin", -1);
+	latency("handoff, spin forced to BFIFO_SPIN", BFIFO_SPIN);
+	latency("handoff, park at once", 0);
+
+	fifo = fifo_create(16, NULL);
+	bfifo = bfifo_create(16, NULL);
+	idle_cpu("bfifo_pop_wait", wait_bfifo);
+	idle_cpu("fifo_empty busy poll", poll_spin);
+	idle_cpu("fifo_empty sched_yield poll", poll_yield);
+	idle_cpu("fifo_empty usleep(100) poll", poll_sleep);
+	bfifo_destroy(bfifo);
+	fifo_destroy(fifo);
+
+	return 0;
+}
@@ -0,0 +1,87 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <unistd.h>
+#include "tvector.h"
+#include "fvector.h"
+#include "bench.h"
+
+#define PATH		"/tmp/fvector_bench.bin"
+#define COUNT		10000000
+#define LOOKUPS		100000
+
+/**
+ * Lookup table entry
+ */
+typedef struct _Entry {
+	uint64_t	key;
+	uint64_t	value;
+} Entry;
+
+// Time until the table is ready and answered its first lookups
+static void report(const char* variant, uint64_t ready, uint64_t answered) {
+	bench_report("fvector startup", variant, (double)ready / 1000000, "ms to open");
+	bench_report("fvector startup", variant, (double)answered / 1000000, "ms to first lookups");
+}
+
+static uint64_t lookup(void*(*get)(void*, size_t), void* table) {
+	uint64_t sum = 0;
+	for(int i = 0; i < LOOKUPS; i++)
+		sum += ((Entry*)get(table, bench_random() % COUNT))->value;
+
+	return sum;
+}
+
+static void* tvector_at(void* table, size_t index) {
+	return tvector_get(table, index);
+}
+
+static void* fvector_at(void* table, size_t index) {
+	return fvector_get(table, index);
+}
+
+// Rebuilding the table with tvector_add at every start
+static void rebuild() {
+	uint64_t start = bench_now();
+	TypedVector* tvector = tvector_create(sizeof(Entry), 16, NULL);
+	for(uint64_t i = 0; i < COUNT; i++) {
+		Entry entry = { i, i * 3 };
+		tvector_add(tvector, &entry);
+	}
+	uint64_t ready = bench_now() - start;
+
+	BENCH_USE(lookup(tvector_at, tvector));
+	report("rebuild with tvector_add", ready, bench_now() - start);
+
+	tvector_destroy(tvector);
+}
+
+// Building the file once, then mapping it at every start
+static void reopen() {
+	unlink(PATH);
+	uint64_t start = bench_now();
+	FileVector* fvector = fvector_open(PATH, sizeof(Entry), 16, NULL);
+	for(uint64_t i = 0; i < COUNT; i++) {
+		Entry entry = { i, i * 3 };
+		fvector_add(fvector, &entry);
+	}
+	fvector_checkpoint(fvector, true);
+	fvector_close(fvector);
+	bench_report("fvector startup", "first build and checkpoint", (double)(bench_now() - start) / 1000000, "ms");
+
+	start = bench_now();
+	fvector = fvector_open(PATH, sizeof(Entry), 16, NULL);
+	uint64_t ready = bench_now() - start;
+
+	BENCH_USE(lookup(fvector_at, fvector));
+	report("reopen with fvector_open", ready, bench_now() - start);
+
+	fvector_close(fvector);
+	unlink(PATH);
+}
+
+int main(int argc, char** argv) {
+	rebuild();
+	reopen();
+
+	return 0;
+}
@@ -0,0 +1,97 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <malloc.h>
+#include "map.h"
+#include "set.h"
+#include "bench.h"
+
+#define KEYS		(8UL * 1024 * 1024)
+#define LOOKUPS		(4UL * 1024 * 1024)
+
+static uint64_t* keys;
+static void** probes;
+
+static size_t heap_used() {
+	struct mallinfo2 info = mallinfo2();
+	return info.uordblks + info.hblkhd;
+}
+
+static void report(const char* name, const char* variant, size_t batch, uint64_t time) {
+	char text[64];
+	if(batch)
+		sprintf(text, "%s, %zu keys per batch", variant, batch);
+	else
+		sprintf(text, "%s", variant);
+	bench_report(name, text, (double)time / LOOKUPS, "ns/key");
+}
+
+// Bursts of keys looked up one by one against map_get_batch, on a table far bigger than the cache
+static void map() {
+	size_t used = heap_used();
+	Map* map = map_create(KEYS, NULL, NULL, NULL);
+	for(size_t i = 0; i < KEYS; i++)
+		map_put(map, (void*)keys[i], (void*)keys[i]);
+	bench_report("map batch", "table size", (double)(heap_used() - used) / 1024 / 1024, "MB");
+
+	uintptr_t sum = 0;
+	uint64_t start = bench_now();
+	for(size_t i = 0; i < LOOKUPS; i++)
+		sum += (uintptr_t)map_get(map, probes[i]);
+	report("map batch", "map_get", 0, bench_now() - start);
+
+	void* datas[256];
+	for(size_t batch = 32; batch <= 256; batch *= 2) {
+		start = bench_now();
+		for(size_t i = 0; i < LOOKUPS; i += batch) {
+			sum += map_get_batch(map, &probes[i], datas, batch);
+			sum += (uintptr_t)datas[0];
+		}
+		report("map batch", "map_get_batch", batch, bench_now() - start);
+	}
+	BENCH_USE(sum);
+
+	map_destroy(map);
+}
+
+static void set() {
+	Set* set = set_create(KEYS, NULL, NULL, NULL);
+	for(size_t i = 0; i < KEYS; i++)
+		set_put(set, (void*)keys[i]);
+
+	size_t found = 0;
+	uint64_t start = bench_now();
+	for(size_t i = 0; i < LOOKUPS; i++)
+		found += set_contains(set, probes[i]);
+	report("set batch", "set_contains", 0, bench_now() - start);
+
+	bool results[256];
+	for(size_t batch = 32; batch <= 256; batch *= 2) {
+		start = bench_now();
+		for(size_t i = 0; i < LOOKUPS; i += batch)
+			found += set_contains_batch(set, &probes[i], results, batch);
+		report("set batch", "set_contains_batch", batch, bench_now() - start);
+	}
+	BENCH_USE(found);
+
+	set_destroy(set);
+}
+
+int main(int argc, char** argv) {
+	// map_uint64_hash does not mix the bits, so random keys spread the buckets randomly
+	keys = malloc(sizeof(uint64_t) * KEYS);
+	for(size_t i = 0; i < KEYS; i++)
+		keys[i] = bench_random() | 1;
+
+	// Three quarters of the probed keys are in the table
+	probes = malloc(sizeof(void*) * LOOKUPS);
+	for(size_t i = 0; i < LOOKUPS; i++)
+		probes[i] = (void*)(bench_random() % 4 ? keys[bench_random() % KEYS] : bench_random() | 1);
+
+	map();
+	set();
+
+	free(probes);
+	free(keys);
+	return 0;
+}
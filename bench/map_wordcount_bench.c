@@ -0,0 +1,85 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "map.h"
+#include "bench.h"
+
+#define VOCABULARY	50000
+#define WORDS		5000000
+
+static char (*vocabulary)[16];
+static char** text;
+
+// map_string_hash only sums the characters, which puts the words in few buckets
+static uint64_t fnv1a(void* key) {
+	uint64_t hash = 14695981039346656037UL;
+	for(unsigned char* c = key; *c; c++)
+		hash = (hash ^ *c) * 1099511628211UL;
+
+	return hash;
+}
+
+static void* increment(void* key, void* data, void* context) {
+	return (void*)((uintptr_t)data + 1);
+}
+
+// Counting every word of the text, the count is stored as the data of the word
+static void count(int kind) {
+	const char* names[] = { "map_get + map_update/map_put", "map_get_or_insert", "map_compute" };
+	Map* map = map_create(VOCABULARY, fnv1a, map_string_equals, NULL);
+
+	uint64_t start = bench_now();
+	for(size_t i = 0; i < WORDS; i++) {
+		char* word = text[i];
+		if(kind == 0) {
+			uintptr_t count = (uintptr_t)map_get(map, word);
+			if(count)
+				map_update(map, word, (void*)(count + 1));
+			else
+				map_put(map, word, (void*)1);
+		} else if(kind == 1) {
+			bool inserted;
+			MapEntry* entry = map_get_or_insert(map, word, (void*)1, &inserted);
+			if(!inserted)
+				entry->data = (void*)((uintptr_t)entry->data + 1);
+		} else {
+			map_compute(map, word, increment, NULL);
+		}
+	}
+	uint64_t time = bench_now() - start;
+
+	uintptr_t total = 0;
+	for(size_t i = 0; i < VOCABULARY; i++)
+		total += (uintptr_t)map_get(map, vocabulary[i]);
+	if(total != WORDS)
+		printf("map wordcount: %zu words counted\n", (size_t)total);
+
+	bench_report("map wordcount", names[kind], (double)time / WORDS, "ns/word");
+	map_destroy(map);
+}
+
+int main(int argc, char** argv) {
+	vocabulary = malloc(sizeof(*vocabulary) * VOCABULARY);
+	for(size_t i = 0; i < VOCABULARY; i++)
+		sprintf(vocabulary[i], "w%zx", i * 2654435761UL % 0xfffffff);
+
+	// Roughly Zipf distributed: a few words are very common, most are rare
+	text = malloc(sizeof(char*) * WORDS);
+	for(size_t i = 0; i < WORDS; i++) {
+		size_t rank = bench_random() % VOCABULARY;
+		text[i] = vocabulary[bench_random() % (rank + 1)];
+	}
+
+	// Faults in the text and the words before the first measurement
+	uint64_t sum = 0;
+	for(size_t i = 0; i < WORDS; i++)
+		sum += fnv1a(text[i]);
+	BENCH_USE(sum);
+
+	for(int kind = 0; kind < 3; kind++)
+		count(kind);
+
+	free(text);
+	free(vocabulary);
+	return 0;
+}
@@ -0,0 +1,98 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <sched.h>
+#include <pthread.h>
+#include "ring.h"
+#include "mpsc_ring.h"
+#include "bench.h"
+
+#define MESSAGES	4000000		// in total over all producers
+#define MESSAGE		64
+#define RING_SIZE	(256 * 1024)
+#define PRODUCERS	8
+
+static int producers;
+static MPSCRing* mpsc;
+
+static char buf[RING_SIZE];
+static size_t head;
+static size_t tail;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void* produce_mpsc(void* arg) {
+	char message[MESSAGE];
+	memset(message, 'm', sizeof(message));
+
+	for(int i = 0; i < MESSAGES / producers; i++)
+		while(!mpsc_ring_write(mpsc, message, MESSAGE))
+			sched_yield();
+
+	return NULL;
+}
+
+// ring_write is single producer, so the producers share it under a mutex
+static void* produce_mutex(void* arg) {
+	char message[MESSAGE];
+	memset(message, 'm', sizeof(message));
+
+	for(int i = 0; i < MESSAGES / producers; i++) {
+		while(true) {
+			pthread_mutex_lock(&lock);
+			bool written = ring_writable(__atomic_load_n(&head, __ATOMIC_RELAXED), tail, RING_SIZE) >= MESSAGE;
+			if(written)
+				ring_write(buf, __atomic_load_n(&head, __ATOMIC_RELAXED), &tail, RING_SIZE, message, MESSAGE);
+			pthread_mutex_unlock(&lock);
+
+			if(written)
+				break;
+			sched_yield();
+		}
+	}
+
+	return NULL;
+}
+
+static void run(const char* kind, int count, void*(*produce)(void*)) {
+	producers = count;
+	mpsc = mpsc_ring_create(RING_SIZE, NULL);
+	head = tail = 0;
+
+	pthread_t threads[PRODUCERS];
+	uint64_t start = bench_now();
+	for(int i = 0; i < count; i++)
+		pthread_create(&threads[i], NULL, produce, NULL);
+
+	// Single consumer drains everything in order
+	char data[4096];
+	size_t total = (size_t)(MESSAGES / count) * count * MESSAGE;
+	for(size_t read = 0; read < total;) {
+		size_t n;
+		if(produce == produce_mpsc)
+			n = mpsc_ring_read(mpsc, data, sizeof(data));
+		else
+			n = ring_read(buf, &head, __atomic_load_n(&tail, __ATOMIC_RELAXED), RING_SIZE, data, sizeof(data));
+
+		read += n;
+		if(n == 0)
+			sched_yield();
+	}
+	for(int i = 0; i < count; i++)
+		pthread_join(threads[i], NULL);
+	uint64_t time = bench_now() - start;
+
+	char variant[64];
+	sprintf(variant, "%s, %d producers", kind, count);
+	bench_report("mpsc_ring", variant, (double)total / MESSAGE / time * 1000, "M messages/s");
+
+	mpsc_ring_destroy(mpsc);
+}
+
+int main(int argc, char** argv) {
+	for(int count = 1; count <= PRODUCERS; count *= 2) {
+		run("mpsc_ring_write", count, produce_mpsc);
+		run("ring_write under a mutex", count, produce_mutex);
+	}
+
+	return 0;
+}
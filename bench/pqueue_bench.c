@@ -0,0 +1,93 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "pqueue.h"
+#include "list.h"
+#include "bench.h"
+
+#define OPERATIONS	200000
+#define BULK		1000000
+
+// Hold model of a timer queue: pop the earliest timer, then push a later one
+static void hold_pqueue(size_t size) {
+	PriorityQueue* pqueue = pqueue_create(size + 1, NULL);
+	uint64_t clock = 0;
+	for(size_t i = 0; i < size; i++)
+		pqueue_push(pqueue, i * 16 + bench_random() % 16, NULL);
+
+	uint64_t start = bench_now();
+	for(int i = 0; i < OPERATIONS; i++) {
+		clock = pqueue_peek(pqueue)->priority;
+		pqueue_pop(pqueue);
+		pqueue_push(pqueue, clock + bench_random() % (size * 16), NULL);
+	}
+	uint64_t time = bench_now() - start;
+
+	char variant[64];
+	sprintf(variant, "pqueue, %zu pending", size);
+	bench_report("pqueue hold", variant, (double)time / OPERATIONS, "ns/op");
+	pqueue_destroy(pqueue);
+}
+
+// The same with a List kept sorted by linear search and list_add_at
+static void hold_list(size_t size) {
+	List* list = list_create(NULL);
+	uint64_t clock = 0;
+	for(size_t i = 0; i < size; i++)
+		list_add(list, (void*)(i * 16 + bench_random() % 16));
+
+	size_t operations = size > 1000 ? OPERATIONS / 100 : OPERATIONS;
+	uint64_t start = bench_now();
+	for(size_t i = 0; i < operations; i++) {
+		clock = (uintptr_t)list_remove_first(list);
+
+		uintptr_t priority = clock + bench_random() % (size * 16);
+		ListIterator iter;
+		list_iterator_init(&iter, list);
+		size_t index = 0;
+		while(list_iterator_has_next(&iter) && (uintptr_t)list_iterator_next(&iter) <= priority)
+			index++;
+		list_add_at(list, index, (void*)priority);
+	}
+	uint64_t time = bench_now() - start;
+
+	char variant[64];
+	sprintf(variant, "sorted List, %zu pending", size);
+	bench_report("pqueue hold", variant, (double)time / operations, "ns/op");
+	list_destroy(list);
+}
+
+// Bulk load by pqueue_heapify against one pqueue_push per element
+static void bulk() {
+	PriorityQueueEntry* entries = malloc(sizeof(PriorityQueueEntry) * BULK);
+	for(size_t i = 0; i < BULK; i++) {
+		entries[i].priority = bench_random();
+		entries[i].data = NULL;
+	}
+
+	PriorityQueue* pqueue = pqueue_create(BULK, NULL);
+	uint64_t start = bench_now();
+	pqueue_heapify(pqueue, entries, BULK);
+	bench_report("pqueue bulk", "pqueue_heapify, 1M", (double)(bench_now() - start) / BULK, "ns/element");
+	pqueue_destroy(pqueue);
+
+	pqueue = pqueue_create(BULK, NULL);
+	start = bench_now();
+	for(size_t i = 0; i < BULK; i++)
+		pqueue_push(pqueue, entries[i].priority, NULL);
+	bench_report("pqueue bulk", "pqueue_push, 1M", (double)(bench_now() - start) / BULK, "ns/element");
+	pqueue_destroy(pqueue);
+
+	free(entries);
+}
+
+int main(int argc, char** argv) {
+	size_t sizes[] = { 16, 256, 4096, 65536 };
+	for(int i = 0; i < 4; i++) {
+		hold_pqueue(sizes[i]);
+		hold_list(sizes[i]);
+	}
+	bulk();
+
+	return 0;
+}
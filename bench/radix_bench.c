@@ -0,0 +1,145 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "radix.h"
+#include "map.h"
+#include "bench.h"
+
+#define KEYS		1000000
+#define PREFIXES	100000
+#define LOOKUPS		1000000
+
+// map_string_hash only sums the characters, which puts similar hostnames in few buckets
+static uint64_t fnv1a(void* key) {
+	uint64_t hash = 14695981039346656037UL;
+	for(unsigned char* c = key; *c; c++)
+		hash = (hash ^ *c) * 1099511628211UL;
+
+	return hash;
+}
+
+static void report(const char* name, const char* variant, uint64_t time) {
+	bench_report(name, variant, (double)time / LOOKUPS, "ns/lookup");
+}
+
+// Exact lookups of hostnames
+static void strings() {
+	char (*hosts)[32] = malloc(sizeof(*hosts) * KEYS);
+	RadixTree* radix = radix_create(NULL);
+	Map* map = map_create(KEYS, fnv1a, map_string_equals, NULL);
+	for(size_t i = 0; i < KEYS; i++) {
+		sprintf(hosts[i], "host%zu.zone%zu.example.com", (size_t)(bench_random() % 100000000), i % 100);
+		radix_put(radix, hosts[i], strlen(hosts[i]), hosts[i]);
+		map_put(map, hosts[i], hosts[i]);
+	}
+
+	size_t* probes = malloc(sizeof(size_t) * LOOKUPS);
+	for(size_t i = 0; i < LOOKUPS; i++)
+		probes[i] = bench_random() % KEYS;
+
+	uintptr_t sum = 0;
+	uint64_t start = bench_now();
+	for(size_t i = 0; i < LOOKUPS; i++) {
+		const char* host = hosts[probes[i]];
+		sum += (uintptr_t)radix_get(radix, host, strlen(host));
+	}
+	report("radix string", "radix_get, 1M hostnames", bench_now() - start);
+
+	start = bench_now();
+	for(size_t i = 0; i < LOOKUPS; i++)
+		sum += (uintptr_t)map_get(map, hosts[probes[i]]);
+	report("radix string", "map_get with FNV-1a, 1M hostnames", bench_now() - start);
+	BENCH_USE(sum);
+
+	map_destroy(map);
+	radix_destroy(radix);
+	free(probes);
+	free(hosts);
+}
+
+// Exact lookups of 64 bit integers, stored big endian in the tree so that they sort
+static void integers() {
+	uint64_t* keys = malloc(sizeof(uint64_t) * KEYS);
+	RadixTree* radix = radix_create(NULL);
+	Map* map = map_create(KEYS, NULL, NULL, NULL);
+	for(size_t i = 0; i < KEYS; i++) {
+		keys[i] = bench_random() | 1;
+		uint64_t key = __builtin_bswap64(keys[i]);
+		radix_put(radix, &key, sizeof(key), (void*)keys[i]);
+		map_put(map, (void*)keys[i], (void*)keys[i]);
+	}
+
+	uintptr_t sum = 0;
+	uint64_t start = bench_now();
+	for(size_t i = 0; i < LOOKUPS; i++) {
+		uint64_t key = __builtin_bswap64(keys[bench_random() % KEYS]);
+		sum += (uintptr_t)radix_get(radix, &key, sizeof(key));
+	}
+	report("radix integer", "radix_get, 1M keys", bench_now() - start);
+
+	start = bench_now();
+	for(size_t i = 0; i < LOOKUPS; i++)
+		sum += (uintptr_t)map_get(map, (void*)keys[bench_random() % KEYS]);
+	report("radix integer", "map_get, 1M keys", bench_now() - start);
+	BENCH_USE(sum);
+
+	map_destroy(map);
+	radix_destroy(radix);
+	free(keys);
+}
+
+// Longest prefix match of IPv4 addresses on /8, /16 and /24 routes, the Map probes each length
+// with the prefix in the low bits of the key as map_uint64_hash does not mix them
+static void prefixes() {
+	RadixTree* radix = radix_create(NULL);
+	Map* map = map_create(PREFIXES, NULL, NULL, NULL);
+	for(size_t i = 0; i < PREFIXES; i++) {
+		uint32_t address = bench_random();
+		size_t len = i < 200 ? 1 : i < 20000 ? 2 : 3;
+		uint8_t key[4] = { address >> 24, address >> 16, address >> 8, address };
+		radix_put(radix, key, len, (void*)(i + 1));
+
+		uint64_t prefix = address >> (32 - len * 8);
+		map_put(map, (void*)((uint64_t)len << 32 | prefix), (void*)(i + 1));
+	}
+
+	uint32_t* addresses = malloc(sizeof(uint32_t) * LOOKUPS);
+	for(size_t i = 0; i < LOOKUPS; i++)
+		addresses[i] = bench_random();
+
+	uintptr_t sum = 0;
+	uint64_t start = bench_now();
+	for(size_t i = 0; i < LOOKUPS; i++) {
+		uint32_t address = addresses[i];
+		uint8_t key[4] = { address >> 24, address >> 16, address >> 8, address };
+		sum += (uintptr_t)radix_longest_prefix(radix, key, sizeof(key), NULL);
+	}
+	report("radix prefix", "radix_longest_prefix, 100K routes", bench_now() - start);
+
+	start = bench_now();
+	for(size_t i = 0; i < LOOKUPS; i++) {
+		for(size_t len = 3; len > 0; len--) {
+			uint64_t prefix = addresses[i] >> (32 - len * 8);
+			void* data = map_get(map, (void*)((uint64_t)len << 32 | prefix));
+			if(data) {
+				sum += (uintptr_t)data;
+				break;
+			}
+		}
+	}
+	report("radix prefix", "map_get per prefix length, 100K routes", bench_now() - start);
+	BENCH_USE(sum);
+
+	map_destroy(map);
+	radix_destroy(radix);
+	free(addresses);
+}
+
+int main(int argc, char** argv) {
+	strings();
+	integers();
+	prefixes();
+
+	return 0;
+}
@@ -0,0 +1,100 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "map.h"
+#include "rcu_map.h"
+#include "bench.h"
+
+#define KEYS		1024
+#define LOOKUPS		(4UL * 1024 * 1024)
+
+static RCUMap* rmap;
+static Map* lmap;
+static pthread_rwlock_t rwlock = PTHREAD_RWLOCK_INITIALIZER;
+static bool rcu;
+static volatile bool done;
+
+static void* read_keys(void* arg) {
+	uint64_t sum = 0;
+	uintptr_t key = (uintptr_t)arg;
+	for(uint64_t i = 0; i < LOOKUPS; i++) {
+		key = key * 2654435761UL % KEYS;
+		if(rcu) {
+			sum += (uintptr_t)rcu_map_get(rmap, (void*)(key + 1));
+		} else {
+			pthread_rwlock_rdlock(&rwlock);
+			sum += (uintptr_t)map_get(lmap, (void*)(key + 1));
+			pthread_rwlock_unlock(&rwlock);
+		}
+	}
+
+	return (void*)sum;
+}
+
+// Updates a route every 100 us, far more often than the routing table does
+static void* write_keys(void* arg) {
+	uintptr_t key = 0;
+	while(!__atomic_load_n(&done, __ATOMIC_ACQUIRE)) {
+		key = (key + 1) % KEYS;
+		if(rcu) {
+			rcu_map_update(rmap, (void*)(key + 1), (void*)key);
+		} else {
+			pthread_rwlock_wrlock(&rwlock);
+			map_update(lmap, (void*)(key + 1), (void*)key);
+			pthread_rwlock_unlock(&rwlock);
+		}
+		usleep(100);
+	}
+
+	return NULL;
+}
+
+// Total lookups per second of a number of reader threads with one writer
+static void scaling(int count, bool lock_free) {
+	rcu = lock_free;
+	done = false;
+
+	pthread_t writer;
+	pthread_t readers[32];
+	pthread_create(&writer, NULL, write_keys, NULL);
+
+	uint64_t start = bench_now();
+	for(int i = 0; i < count; i++)
+		pthread_create(&readers[i], NULL, read_keys, (void*)(uintptr_t)(i + 1));
+
+	uint64_t sum = 0;
+	for(int i = 0; i < count; i++) {
+		void* result;
+		pthread_join(readers[i], &result);
+		sum += (uintptr_t)result;
+	}
+	uint64_t time = bench_now() - start;
+	BENCH_USE(sum);
+
+	__atomic_store_n(&done, true, __ATOMIC_RELEASE);
+	pthread_join(writer, NULL);
+
+	char variant[64];
+	sprintf(variant, "%s, %d readers", lock_free ? "rcu_map_get" : "rwlock + map_get", count);
+	bench_report("rcu_map", variant, (double)LOOKUPS * count / time * 1000, "M lookups/s");
+}
+
+int main(int argc, char** argv) {
+	rmap = rcu_map_create(KEYS * 2, NULL, NULL, NULL);
+	lmap = map_create(KEYS * 2, NULL, NULL, NULL);
+	for(uintptr_t key = 0; key < KEYS; key++) {
+		rcu_map_put(rmap, (void*)(key + 1), (void*)key);
+		map_put(lmap, (void*)(key + 1), (void*)key);
+	}
+
+	for(int count = 1; count <= 32; count *= 2) {
+		scaling(count, false);
+		scaling(count, true);
+	}
+
+	map_destroy(lmap);
+	rcu_map_destroy(rmap);
+	return 0;
+}
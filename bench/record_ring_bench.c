@@ -0,0 +1,66 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <sched.h>
+#include <pthread.h>
+#include "record_ring.h"
+#include "bench.h"
+
+#define COUNT		5000000
+#define RING_SIZE	(256 * 1024)
+
+static RecordRing* rring;
+static size_t size;
+
+static void* produce(void* arg) {
+	char record[1024];
+	memset(record, 'r', sizeof(record));
+
+	for(int i = 0; i < COUNT; i++)
+		while(!record_ring_write(rring, record, size))
+			sched_yield();
+
+	return NULL;
+}
+
+// Records from a producer thread read by a consumer in batches
+static void records(size_t record_size, size_t batch) {
+	rring = record_ring_create(RING_SIZE, NULL);
+	size = record_size;
+
+	struct iovec records[64];
+	uint64_t sum = 0;
+	pthread_t producer;
+	uint64_t start = bench_now();
+	pthread_create(&producer, NULL, produce, NULL);
+
+	for(size_t received = 0; received < COUNT;) {
+		size_t count = record_ring_read_batch(rring, records, batch);
+		for(size_t i = 0; i < count; i++)
+			sum += ((char*)records[i].iov_base)[0];
+		record_ring_release(rring);
+
+		received += count;
+		if(count == 0)
+			sched_yield();
+	}
+	pthread_join(producer, NULL);
+	uint64_t time = bench_now() - start;
+	BENCH_USE(sum);
+
+	char variant[64];
+	sprintf(variant, "%zu byte records, batch %zu", record_size, batch);
+	bench_report("record_ring", variant, (double)COUNT / time * 1000, "M records/s");
+
+	record_ring_destroy(rring);
+}
+
+int main(int argc, char** argv) {
+	size_t sizes[] = { 16, 64, 256 };
+	for(int i = 0; i < 3; i++) {
+		records(sizes[i], 1);
+		records(sizes[i], 64);
+	}
+
+	return 0;
+}
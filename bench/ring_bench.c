@@ -0,0 +1,90 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <sched.h>
+#include <pthread.h>
+#include "ring.h"
+#include "bench.h"
+
+#define TOTAL		(256UL * 1024 * 1024)
+#define RING_SIZE	(64 * 1024)
+
+static Ring* ring;
+static size_t chunk;
+static bool zero_copy;
+
+static void* produce(void* arg) {
+	char data[16384];
+	memset(data, 'x', sizeof(data));
+
+	uint64_t position = 0;
+	while(position < TOTAL) {
+		size_t len;
+		if(zero_copy) {
+			struct iovec vec[2];
+			len = ring_write_reserve(ring, vec, chunk);
+			memset(vec[0].iov_base, 'x', vec[0].iov_len);
+			memset(vec[1].iov_base, 'x', vec[1].iov_len);
+			ring_write_commit(ring, len);
+		} else {
+			len = ring_push(ring, data, chunk);
+		}
+
+		position += len;
+		if(len == 0)
+			sched_yield();
+	}
+
+	return NULL;
+}
+
+// Bytes streamed from a producer thread to a consumer thread
+static void throughput(size_t size, bool in_place) {
+	ring = ring_create(RING_SIZE, NULL);
+	chunk = size;
+	zero_copy = in_place;
+
+	char data[16384];
+	uint64_t sum = 0;
+	pthread_t producer;
+	uint64_t start = bench_now();
+	pthread_create(&producer, NULL, produce, NULL);
+
+	uint64_t position = 0;
+	while(position < TOTAL) {
+		size_t len;
+		if(zero_copy) {
+			struct iovec vec[2];
+			len = ring_read_peek(ring, vec, chunk);
+			if(len)
+				sum += ((char*)vec[0].iov_base)[0];
+			ring_read_consume(ring, len);
+		} else {
+			len = ring_pop(ring, data, chunk);
+			sum += data[0];
+		}
+
+		position += len;
+		if(len == 0)
+			sched_yield();
+	}
+	pthread_join(producer, NULL);
+	uint64_t time = bench_now() - start;
+	BENCH_USE(sum);
+
+	char variant[64];
+	sprintf(variant, "%s, %zu byte chunks", in_place ? "reserve/peek" : "push/pop", size);
+	bench_report("ring spsc", variant, (double)TOTAL / time * 1000, "MB/s");
+
+	ring_destroy(ring);
+}
+
+int main(int argc, char** argv) {
+	size_t sizes[] = { 64, 1024, 16384 };
+	for(int i = 0; i < 3; i++) {
+		throughput(sizes[i], false);
+		throughput(sizes[i], true);
+	}
+
+	return 0;
+}
@@ -0,0 +1,121 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include "ring.h"
+#include "bench.h"
+
+#define TOTAL		(256UL * 1024 * 1024)
+#define RING_SIZE	(64 * 1024)
+#define CHUNK		(16 * 1024)
+
+// Writes TOTAL bytes into the source descriptor
+static void* feed(void* arg) {
+	int fd = (intptr_t)arg;
+	char data[CHUNK];
+	memset(data, 'x', sizeof(data));
+
+	uint64_t position = 0;
+	while(position < TOTAL) {
+		ssize_t len = write(fd, data, sizeof(data) < TOTAL - position ? sizeof(data) : TOTAL - position);
+		if(len < 0)
+			break;
+		position += len;
+	}
+
+	return NULL;
+}
+
+// Reads everything from the sink descriptor
+static void* sink(void* arg) {
+	int fd = (intptr_t)arg;
+	char data[CHUNK];
+
+	uint64_t position = 0;
+	while(position < TOTAL) {
+		ssize_t len = read(fd, data, sizeof(data));
+		if(len <= 0)
+			break;
+		position += len;
+	}
+
+	return NULL;
+}
+
+// Relays TOTAL bytes from one descriptor pair to another through a Ring
+static void relay(const char* kind, bool direct) {
+	int in[2];
+	int out[2];
+	if(strcmp(kind, "pipe") == 0) {
+		if(pipe(in) < 0 || pipe(out) < 0)
+			return;
+	} else {
+		if(socketpair(AF_UNIX, SOCK_STREAM, 0, in) < 0 || socketpair(AF_UNIX, SOCK_STREAM, 0, out) < 0)
+			return;
+	}
+
+	Ring* ring = ring_create(RING_SIZE, NULL);
+	pthread_t feeder;
+	pthread_t sinker;
+	uint64_t start = bench_now();
+	uint64_t cpu = bench_cpu();
+	pthread_create(&feeder, NULL, feed, (void*)(intptr_t)in[1]);
+	pthread_create(&sinker, NULL, sink, (void*)(intptr_t)out[0]);
+
+	char data[CHUNK];
+	uint64_t received = 0;
+	uint64_t sent = 0;
+	while(sent < TOTAL) {
+		if(received < TOTAL && ring_available(ring)) {
+			ssize_t len;
+			if(direct) {
+				len = ring_fill_from_fd(ring, in[0], CHUNK);
+			} else {
+				// The application buffer the Ring helpers remove
+				size_t space = ring_space(ring);
+				len = read(in[0], data, space < CHUNK ? space : CHUNK);
+				if(len > 0)
+					ring_push(ring, data, len);
+			}
+			if(len > 0)
+				received += len;
+		}
+
+		ssize_t len;
+		if(direct) {
+			len = ring_drain_to_fd(ring, out[1], CHUNK);
+		} else {
+			len = ring_pop(ring, data, CHUNK);
+			if(len > 0)
+				len = write(out[1], data, len);
+		}
+		if(len > 0)
+			sent += len;
+	}
+	pthread_join(feeder, NULL);
+	pthread_join(sinker, NULL);
+	uint64_t time = bench_now() - start;
+	cpu = bench_cpu() - cpu;
+
+	char variant[64];
+	sprintf(variant, "%s, %s", kind, direct ? "ring_fill/drain_fd" : "read/write + push/pop");
+	bench_report("ring fd relay", variant, (double)TOTAL / time * 1000, "MB/s");
+	bench_report("ring fd relay", variant, (double)cpu / (TOTAL / 1024), "cpu ns/KB");
+
+	ring_destroy(ring);
+	close(in[0]);
+	close(in[1]);
+	close(out[0]);
+	close(out[1]);
+}
+
+int main(int argc, char** argv) {
+	relay("pipe", false);
+	relay("pipe", true);
+	relay("socketpair", false);
+	relay("socketpair", true);
+
+	return 0;
+}
@@ -0,0 +1,55 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "ring.h"
+#include "bench.h"
+
+#define TOTAL		(512UL * 1024 * 1024)
+#define RING_SIZE	4096
+
+// Odd-sized records are written and parsed in place. A record which wraps on
+// a plain Ring has to be copied out to be parsed, a mirrored Ring never wraps.
+static void records(Ring* ring, const char* kind, size_t size) {
+	char record[2048];
+	char scratch[2048];
+	memset(record, 'r', size);
+
+	uint64_t sum = 0;
+	uint64_t copied = 0;
+	uint64_t start = bench_now();
+	for(uint64_t position = 0; position < TOTAL; position += size) {
+		ring_push(ring, record, size);
+
+		struct iovec vec[2];
+		ring_read_peek(ring, vec, size);
+		const char* parsed = vec[0].iov_base;
+		if(vec[1].iov_len) {
+			memcpy(scratch, vec[0].iov_base, vec[0].iov_len);
+			memcpy(scratch + vec[0].iov_len, vec[1].iov_base, vec[1].iov_len);
+			parsed = scratch;
+			copied++;
+		}
+		sum += parsed[size - 1];
+		ring_read_consume(ring, size);
+	}
+	uint64_t time = bench_now() - start;
+	BENCH_USE(sum);
+
+	char variant[64];
+	sprintf(variant, "%s, %zu byte records", kind, size);
+	bench_report("ring mirrored", variant, (double)TOTAL / time * 1000, "MB/s");
+	sprintf(variant, "%s, %zu byte records, copied out", kind, size);
+	bench_report("ring mirrored", variant, (double)copied * size / TOTAL * 100, "% of bytes");
+
+	ring_destroy(ring);
+}
+
+int main(int argc, char** argv) {
+	size_t sizes[] = { 37, 333, 1021 };
+	for(int i = 0; i < 3; i++) {
+		records(ring_create(RING_SIZE, NULL), "split", sizes[i]);
+		records(ring_create_mirrored(RING_SIZE, NULL), "mirrored", sizes[i]);
+	}
+
+	return 0;
+}
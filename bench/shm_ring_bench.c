@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "shm_ring.h"
+#include "bench.h"
+
+#define NAME		"/shm_ring_bench"
+#define TOTAL		(256UL * 1024 * 1024)
+#define RING_SIZE	(64 * 1024)
+
+// Writer process streams TOTAL bytes in chunks
+static void produce(size_t chunk) {
+	ShmRing* ring = NULL;
+	while(!(ring = shm_ring_attach(NAME, SHM_RING_WRITER, NULL)))
+		sched_yield();
+
+	char data[16384];
+	memset(data, 'x', sizeof(data));
+
+	uint64_t position = 0;
+	while(position < TOTAL) {
+		size_t len = shm_ring_write(ring, data, chunk);
+		position += len;
+		if(len == 0)
+			sched_yield();
+	}
+
+	shm_ring_destroy(ring);
+}
+
+// Bytes streamed from a writer process to a reader process through the segment
+static void shm(size_t chunk) {
+	shm_ring_unlink(NAME);
+	ShmRing* ring = shm_ring_create(NAME, RING_SIZE, SHM_RING_READER, NULL);
+
+	uint64_t start = bench_now();
+	pid_t pid = fork();
+	if(pid == 0) {
+		produce(chunk);
+		_exit(0);
+	}
+
+	char data[16384];
+	uint64_t sum = 0;
+	uint64_t position = 0;
+	while(position < TOTAL) {
+		size_t len = shm_ring_read(ring, data, chunk);
+		sum += data[0];
+		position += len;
+		if(len == 0)
+			sched_yield();
+	}
+	waitpid(pid, NULL, 0);
+	uint64_t time = bench_now() - start;
+	BENCH_USE(sum);
+
+	char variant[64];
+	sprintf(variant, "shm_ring, %zu byte chunks", chunk);
+	bench_report("shm_ring 2-proc", variant, (double)TOTAL / time * 1000, "MB/s");
+
+	shm_ring_destroy(ring);
+	shm_ring_unlink(NAME);
+}
+
+// Same stream through a pipe as the baseline
+static void pipe_stream(size_t chunk) {
+	int fds[2];
+	if(pipe(fds) < 0)
+		return;
+
+	uint64_t start = bench_now();
+	pid_t pid = fork();
+	if(pid == 0) {
+		close(fds[0]);
+		char data[16384];
+		memset(data, 'x', sizeof(data));
+
+		uint64_t position = 0;
+		while(position < TOTAL) {
+			ssize_t len = write(fds[1], data, chunk);
+			if(len < 0)
+				_exit(1);
+			position += len;
+		}
+		_exit(0);
+	}
+	close(fds[1]);
+
+	char data[16384];
+	uint64_t sum = 0;
+	uint64_t position = 0;
+	while(position < TOTAL) {
+		ssize_t len = read(fds[0], data, chunk);
+		if(len <= 0)
+			break;
+		sum += data[0];
+		position += len;
+	}
+	waitpid(pid, NULL, 0);
+	uint64_t time = bench_now() - start;
+	BENCH_USE(sum);
+	close(fds[0]);
+
+	char variant[64];
+	sprintf(variant, "pipe, %zu byte chunks", chunk);
+	bench_report("shm_ring 2-proc", variant, (double)TOTAL / time * 1000, "MB/s");
+}
+
+int main(int argc, char** argv) {
+	size_t sizes[] = { 64, 1024, 16384 };
+	for(int i = 0; i < 3; i++) {
+		shm(sizes[i]);
+		pipe_stream(sizes[i]);
+	}
+
+	return 0;
+}
@@ -0,0 +1,72 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "vector.h"
+#include "bench.h"
+
+#define REQUESTS	1000000
+
+extern void* __libc_malloc(size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+
+static size_t allocations;
+
+// Counts the allocations of the library, which is linked statically into this binary
+void* malloc(size_t size) {
+	allocations++;
+	return __libc_malloc(size);
+}
+
+void* realloc(void* ptr, size_t size) {
+	allocations++;
+	return __libc_realloc(ptr, size);
+}
+
+// A request which collects count pointers in a short lived Vector
+static uintptr_t request(int kind, size_t count) {
+	Vector* vector;
+	SMALL_VECTOR(stack);
+	if(kind == 0)
+		vector = vector_create(VECTOR_INLINE_SIZE, NULL);
+	else if(kind == 1)
+		vector = small_vector_create(NULL);
+	else
+		vector = stack;
+
+	for(uintptr_t i = 0; i < count; i++)
+		vector_add(vector, (void*)i);
+
+	uintptr_t sum = (uintptr_t)vector_get_last(vector);
+	if(kind == 2)
+		small_vector_fini(vector);
+	else
+		vector_destroy(vector);
+
+	return sum;
+}
+
+static void requests(int kind, size_t count) {
+	const char* names[] = { "vector_create", "small_vector_create", "SMALL_VECTOR" };
+
+	allocations = 0;
+	uintptr_t sum = 0;
+	uint64_t start = bench_now();
+	for(int i = 0; i < REQUESTS; i++)
+		sum += request(kind, count);
+	uint64_t time = bench_now() - start;
+	BENCH_USE(sum);
+
+	char variant[64];
+	sprintf(variant, "%s, %zu elements", names[kind], count);
+	bench_report("small_vector", variant, (double)allocations / REQUESTS, "allocs/request");
+	bench_report("small_vector", variant, (double)time / REQUESTS, "ns/request");
+}
+
+int main(int argc, char** argv) {
+	size_t counts[] = { 2, VECTOR_INLINE_SIZE, VECTOR_INLINE_SIZE * 4 };
+	for(int i = 0; i < 3; i++)
+		for(int kind = 0; kind < 3; kind++)
+			requests(kind, counts[i]);
+
+	return 0;
+}
@@ -0,0 +1,89 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "map.h"
+#include "striped_map.h"
+#include "bench.h"
+
+#define KEYS		65536
+#define OPERATIONS	4000000
+
+static StripedMap* smap;
+static Map* lmap;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static bool striped;
+static size_t threads;
+
+// Half gets, a quarter puts and a quarter removes of random keys, like connection tracking
+static void* mix(void* arg) {
+	uint64_t seed = (uintptr_t)arg * BENCH_SEED;
+	uintptr_t sum = 0;
+	for(size_t i = 0; i < OPERATIONS / threads; i++) {
+		bench_xorshift(&seed);
+
+		void* key = (void*)(seed % KEYS + 1);
+		int operation = seed >> 62;
+		if(striped) {
+			if(operation < 2)
+				sum += (uintptr_t)striped_map_get(smap, key);
+			else if(operation == 2)
+				striped_map_put(smap, key, key);
+			else
+				sum += (uintptr_t)striped_map_remove(smap, key);
+		} else {
+			pthread_mutex_lock(&lock);
+			if(operation < 2)
+				sum += (uintptr_t)map_get(lmap, key);
+			else if(operation == 2)
+				map_put(lmap, key, key);
+			else
+				sum += (uintptr_t)map_remove(lmap, key);
+			pthread_mutex_unlock(&lock);
+		}
+	}
+
+	return (void*)sum;
+}
+
+// Total operations per second of a number of threads sharing the map
+static void throughput(size_t count, bool segmented) {
+	striped = segmented;
+	threads = count;
+
+	pthread_t workers[32];
+	uint64_t start = bench_now();
+	for(size_t i = 0; i < count; i++)
+		pthread_create(&workers[i], NULL, mix, (void*)(i + 1));
+
+	uintptr_t sum = 0;
+	for(size_t i = 0; i < count; i++) {
+		void* result;
+		pthread_join(workers[i], &result);
+		sum += (uintptr_t)result;
+	}
+	uint64_t time = bench_now() - start;
+	BENCH_USE(sum);
+
+	char variant[64];
+	sprintf(variant, "%s, %zu threads", segmented ? "striped_map" : "mutex + map", count);
+	bench_report("striped_map mix", variant, (double)OPERATIONS / time * 1000, "M ops/s");
+}
+
+int main(int argc, char** argv) {
+	smap = striped_map_create(KEYS, 0, NULL, NULL, NULL);
+	lmap = map_create(KEYS, NULL, NULL, NULL);
+	for(uintptr_t key = 1; key <= KEYS; key += 2) {
+		striped_map_put(smap, (void*)key, (void*)key);
+		map_put(lmap, (void*)key, (void*)key);
+	}
+
+	for(size_t count = 1; count <= 32; count *= 2) {
+		throughput(count, false);
+		throughput(count, true);
+	}
+
+	striped_map_destroy(smap);
+	map_destroy(lmap);
+	return 0;
+}
@@ -0,0 +1,142 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "treemap.h"
+#include "bench.h"
+
+#define LOOKUPS		1000000
+#define RANGE		100
+
+static int compare(const void* a, const void* b) {
+	uint64_t x = *(const uint64_t*)a;
+	uint64_t y = *(const uint64_t*)b;
+	return x < y ? -1 : x > y;
+}
+
+// First index of array whose key is not less than key
+static size_t lower_bound(uint64_t* array, size_t size, uint64_t key) {
+	size_t low = 0;
+	while(size > 0) {
+		size_t half = size / 2;
+		if(array[low + half] < key) {
+			low += half + 1;
+			size -= half + 1;
+		} else {
+			size = half;
+		}
+	}
+
+	return low;
+}
+
+static void report(const char* name, const char* variant, size_t size, uint64_t time, size_t count) {
+	char text[64];
+	sprintf(text, "%s, %zu keys", variant, size);
+	bench_report(name, text, (double)time / count, "ns/op");
+}
+
+// Build, point lookup, ceiling and range scan against a sorted array searched by binary search
+static void compare_with_array(size_t size) {
+	uint64_t* keys = malloc(sizeof(uint64_t) * size);
+	uint64_t* probes = malloc(sizeof(uint64_t) * LOOKUPS);
+	for(size_t i = 0; i < size; i++)
+		keys[i] = bench_random() >> 1 | 1;
+	for(size_t i = 0; i < LOOKUPS; i++)
+		probes[i] = bench_random() % 2 ? keys[bench_random() % size] : bench_random() >> 1;
+
+	// Build
+	TreeMap* treemap = treemap_create(NULL, NULL);
+	uint64_t start = bench_now();
+	for(size_t i = 0; i < size; i++)
+		treemap_put(treemap, (void*)keys[i], (void*)keys[i]);
+	report("treemap build", "treemap_put", size, bench_now() - start, size);
+
+	uint64_t* array = malloc(sizeof(uint64_t) * size);
+	start = bench_now();
+	for(size_t i = 0; i < size; i++)
+		array[i] = keys[i];
+	qsort(array, size, sizeof(uint64_t), compare);
+	report("treemap build", "append + qsort", size, bench_now() - start, size);
+
+	// Point lookup
+	uint64_t sum = 0;
+	start = bench_now();
+	for(size_t i = 0; i < LOOKUPS; i++)
+		sum += (uintptr_t)treemap_get(treemap, (void*)probes[i]);
+	report("treemap get", "treemap_get", size, bench_now() - start, LOOKUPS);
+
+	start = bench_now();
+	for(size_t i = 0; i < LOOKUPS; i++) {
+		size_t index = lower_bound(array, size, probes[i]);
+		if(index < size && array[index] == probes[i])
+			sum += array[index];
+	}
+	report("treemap get", "binary search", size, bench_now() - start, LOOKUPS);
+
+	// Nearest key
+	start = bench_now();
+	for(size_t i = 0; i < LOOKUPS; i++) {
+		TreeMapEntry entry;
+		if(treemap_ceiling(treemap, (void*)probes[i], &entry))
+			sum += (uintptr_t)entry.key;
+	}
+	report("treemap ceiling", "treemap_ceiling", size, bench_now() - start, LOOKUPS);
+
+	start = bench_now();
+	for(size_t i = 0; i < LOOKUPS; i++) {
+		size_t index = lower_bound(array, size, probes[i]);
+		if(index < size)
+			sum += array[index];
+	}
+	report("treemap ceiling", "binary search", size, bench_now() - start, LOOKUPS);
+
+	// Range scan of RANGE keys from a probe
+	size_t scans = LOOKUPS / 10;
+	start = bench_now();
+	for(size_t i = 0; i < scans; i++) {
+		TreeMapIterator iter;
+		treemap_iterator_lower_bound(&iter, treemap, (void*)probes[i]);
+		for(int j = 0; j < RANGE && treemap_iterator_has_next(&iter); j++)
+			sum += (uintptr_t)treemap_iterator_next(&iter)->data;
+	}
+	report("treemap range", "treemap iterator", size, bench_now() - start, scans);
+
+	start = bench_now();
+	for(size_t i = 0; i < scans; i++) {
+		size_t index = lower_bound(array, size, probes[i]);
+		for(int j = 0; j < RANGE && index < size; j++)
+			sum += array[index++];
+	}
+	report("treemap range", "binary search + scan", size, bench_now() - start, scans);
+
+	// Inserts into the populated set, the array keeps sorted by moving its tail
+	size_t inserts = size / 10;
+	start = bench_now();
+	for(size_t i = 0; i < inserts; i++)
+		treemap_put(treemap, (void*)(probes[i] & ~1UL), NULL);
+	report("treemap insert", "treemap_put", size, bench_now() - start, inserts);
+
+	array = realloc(array, sizeof(uint64_t) * (size + inserts));
+	start = bench_now();
+	for(size_t i = 0; i < inserts; i++) {
+		uint64_t key = probes[i] & ~1UL;
+		size_t index = lower_bound(array, size + i, key);
+		memmove(&array[index + 1], &array[index], sizeof(uint64_t) * (size + i - index));
+		array[index] = key;
+	}
+	report("treemap insert", "binary search + memmove", size, bench_now() - start, inserts);
+	BENCH_USE(sum);
+
+	treemap_destroy(treemap);
+	free(array);
+	free(probes);
+	free(keys);
+}
+
+int main(int argc, char** argv) {
+	compare_with_array(10000);
+	compare_with_array(1000000);
+
+	return 0;
+}
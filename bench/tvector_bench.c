@@ -0,0 +1,91 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <malloc.h>
+#include "vector.h"
+#include "tvector.h"
+#include "bench.h"
+
+#define COUNT		1000000
+#define SCANS		10
+
+// Bytes allocated by malloc, including the chunks it maps
+static size_t heap_used() {
+	struct mallinfo2 info = mallinfo2();
+	return info.uordblks + info.hblkhd;
+}
+
+static void report(const char* name, const char* variant, size_t size, double value, const char* unit) {
+	char text[64];
+	sprintf(text, "%s, %zu byte structs", variant, size);
+	bench_report(name, text, value, unit);
+}
+
+// Summing the first field of every struct, stored inline or through a pointer each
+static void scan(size_t size) {
+	char element[64] = { 0 };
+
+	size_t used = heap_used();
+	TypedVector* tvector = tvector_create(size, 16, NULL);
+	for(uint64_t i = 0; i < COUNT; i++) {
+		memcpy(element, &i, sizeof(i));
+		tvector_add(tvector, element);
+	}
+	report("tvector memory", "TypedVector", size, (double)(heap_used() - used) / COUNT, "bytes/element");
+
+	used = heap_used();
+	Vector* vector = vector_create(16, NULL);
+	for(uint64_t i = 0; i < COUNT; i++) {
+		void* data = malloc(size);
+		memcpy(data, &i, sizeof(i));
+		vector_add(vector, data);
+	}
+	// A big pointer array is mapped by the Vector itself, out of sight of malloc
+	used -= vector->mapped ? vector_capacity(vector) * sizeof(void*) : 0;
+	report("tvector memory", "Vector of pointers", size, (double)(heap_used() - used) / COUNT, "bytes/element");
+
+	uint64_t sum = 0;
+	uint64_t start = bench_now();
+	for(int j = 0; j < SCANS; j++) {
+		TypedVectorIterator iter;
+		tvector_iterator_init(&iter, tvector);
+		while(tvector_iterator_has_next(&iter))
+			sum += *(uint64_t*)tvector_iterator_next(&iter);
+	}
+	report("tvector scan", "TypedVector", size, (double)(bench_now() - start) / COUNT / SCANS, "ns/element");
+
+	start = bench_now();
+	for(int j = 0; j < SCANS; j++)
+		for(size_t i = 0; i < COUNT; i++)
+			sum += *(uint64_t*)vector_get(vector, i);
+	report("tvector scan", "Vector of pointers", size, (double)(bench_now() - start) / COUNT / SCANS, "ns/element");
+
+	// Pointers of a long lived Vector rarely follow allocation order
+	for(size_t i = COUNT - 1; i > 0; i--) {
+		size_t j = bench_random() % (i + 1);
+		void* data = vector->array[i];
+		vector->array[i] = vector->array[j];
+		vector->array[j] = data;
+	}
+
+	start = bench_now();
+	for(int j = 0; j < SCANS; j++)
+		for(size_t i = 0; i < COUNT; i++)
+			sum += *(uint64_t*)vector_get(vector, i);
+	report("tvector scan", "Vector of shuffled pointers", size, (double)(bench_now() - start) / COUNT / SCANS, "ns/element");
+	BENCH_USE(sum);
+
+	for(size_t i = 0; i < COUNT; i++)
+		free(vector_get(vector, i));
+	vector_destroy(vector);
+	tvector_destroy(tvector);
+}
+
+int main(int argc, char** argv) {
+	scan(16);
+	scan(32);
+	scan(64);
+
+	return 0;
+}
@@ -0,0 +1,63 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "vector.h"
+#include "bench.h"
+
+static size_t grows;
+
+static size_t growth_legacy(size_t size, size_t required) {
+	grows++;
+	return size * 1.5 + 1;
+}
+
+static size_t growth_default(size_t size, size_t required) {
+	grows++;
+	return vector_growth_default(size, required);
+}
+
+static size_t growth_double(size_t size, size_t required) {
+	grows++;
+	return vector_growth_double(size, required);
+}
+
+// vector_add of count elements starting from a single element array
+static void append(size_t count, const char* name, size_t(*growth)(size_t, size_t), bool reserve) {
+	grows = 0;
+	uint64_t start = bench_now();
+
+	Vector* vector = vector_create(1, NULL);
+	vector_set_growth(vector, growth);
+	if(reserve)
+		vector_reserve(vector, count);
+
+	for(uintptr_t i = 0; i < count; i++)
+		vector_add(vector, (void*)i);
+
+	uint64_t time = bench_now() - start;
+	BENCH_USE(vector_get_last(vector));
+	vector_destroy(vector);
+
+	char variant[64];
+	sprintf(variant, "%s, %zu elements", name, count);
+	bench_report("vector append", variant, (double)time / count, "ns/add");
+	bench_report("vector append", variant, grows + reserve, "reallocs");
+}
+
+int main(int argc, char** argv) {
+	// Warms up the allocator so that the first case is not charged for it
+	Vector* vector = vector_create(1, NULL);
+	for(uintptr_t i = 0; i < 100000; i++)
+		vector_add(vector, (void*)i);
+	vector_destroy(vector);
+
+	size_t counts[] = { 1000, 100000, 10000000 };
+	for(int i = 0; i < 3; i++) {
+		append(counts[i], "size * 1.5 + 1", growth_legacy, false);
+		append(counts[i], "vector_growth_default", growth_default, false);
+		append(counts[i], "vector_growth_double", growth_double, false);
+		append(counts[i], "vector_reserve", growth_default, true);
+	}
+
+	return 0;
+}
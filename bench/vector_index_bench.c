@@ -0,0 +1,65 @@
+#include <stdio.h>
+#include <stdint.h>
+#include "vector.h"
+#include "bench.h"
+
+#define ELEMENTS	(64UL * 1024 * 1024)
+
+static bool equals(void* a, void* b) {
+	return a == b;
+}
+
+static size_t scalar(Vector* vector, void* data) {
+	for(size_t i = 0; i < vector->index; i++)
+		if(vector->array[i] == data)
+			return i;
+
+	return -1;
+}
+
+// Searching a pointer which is not in the Vector, so every element is compared
+static void index_of(size_t size) {
+	Vector* vector = vector_create(size, NULL);
+	for(uintptr_t i = 0; i < size; i++)
+		vector_add(vector, (void*)(i * 8 + 8));
+
+	size_t rounds = ELEMENTS / size;
+	size_t found = 0;
+	void* missing = (void*)1;
+
+	uint64_t start = bench_now();
+	for(size_t i = 0; i < rounds; i++)
+		found += vector_index_of(vector, missing, NULL);
+	uint64_t simd = bench_now() - start;
+
+	start = bench_now();
+	for(size_t i = 0; i < rounds; i++)
+		found += vector_index_of(vector, missing, equals);
+	uint64_t callback = bench_now() - start;
+
+	start = bench_now();
+	for(size_t i = 0; i < rounds; i++) {
+		found += scalar(vector, missing);
+		// Keeps the compiler from searching once for every round
+		__asm__ volatile("" ::: "memory");
+	}
+	uint64_t loop = bench_now() - start;
+	BENCH_USE(found);
+
+	char variant[64];
+	sprintf(variant, "comp_fn NULL, %zu elements", size);
+	bench_report("vector index_of", variant, (double)simd / ELEMENTS, "ns/element");
+	sprintf(variant, "comp_fn equals, %zu elements", size);
+	bench_report("vector index_of", variant, (double)callback / ELEMENTS, "ns/element");
+	sprintf(variant, "scalar loop, %zu elements", size);
+	bench_report("vector index_of", variant, (double)loop / ELEMENTS, "ns/element");
+
+	vector_destroy(vector);
+}
+
+int main(int argc, char** argv) {
+	for(size_t size = 1000; size <= 10000000; size *= 10)
+		index_of(size);
+
+	return 0;
+}
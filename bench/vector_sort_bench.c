@@ -0,0 +1,87 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "vector.h"
+#include "bench.h"
+
+#define COUNT		4000000
+#define SEARCH_SIZE	100000
+#define SEARCHES	1000
+
+static int compare(const void* a, const void* b) {
+	uintptr_t x = *(const uintptr_t*)a;
+	uintptr_t y = *(const uintptr_t*)b;
+	return x < y ? -1 : x > y;
+}
+
+static Vector* random_vector(size_t count) {
+	Vector* vector = vector_create(count, NULL);
+	for(size_t i = 0; i < count; i++)
+		vector_add(vector, (void*)(uintptr_t)bench_random());
+
+	return vector;
+}
+
+// vector_sort of random pointers with a number of threads, against qsort
+static void sort(size_t threads) {
+	Vector* vector = random_vector(COUNT);
+
+	uint64_t start = bench_now();
+	if(threads)
+		vector_sort(vector, NULL, threads);
+	else
+		qsort(vector->array, COUNT, sizeof(void*), compare);
+	uint64_t time = bench_now() - start;
+
+	for(size_t i = 1; i < COUNT; i++) {
+		if(vector_get(vector, i - 1) > vector_get(vector, i)) {
+			printf("vector_sort: not sorted\n");
+			break;
+		}
+	}
+
+	char variant[64];
+	if(threads)
+		sprintf(variant, "vector_sort, %zu threads, %d elements", threads, COUNT);
+	else
+		sprintf(variant, "qsort, %d elements", COUNT);
+	bench_report("vector sort", variant, (double)time / 1000000, "ms");
+
+	vector_destroy(vector);
+}
+
+// What sorting buys: linear vector_index_of against vector_bsearch
+static void search() {
+	Vector* vector = random_vector(SEARCH_SIZE);
+	size_t found = 0;
+
+	uint64_t start = bench_now();
+	for(int i = 0; i < SEARCHES; i++)
+		found += vector_index_of(vector, vector_get(vector, bench_random() % SEARCH_SIZE), NULL) != (size_t)-1;
+	uint64_t time = bench_now() - start;
+
+	char variant[64];
+	sprintf(variant, "vector_index_of, %d elements", SEARCH_SIZE);
+	bench_report("vector search", variant, (double)time / SEARCHES, "ns/op");
+
+	vector_sort(vector, NULL, 0);
+	start = bench_now();
+	for(int i = 0; i < SEARCHES * 1000; i++)
+		found += vector_bsearch(vector, vector_get(vector, bench_random() % SEARCH_SIZE), NULL) != (size_t)-1;
+	time = bench_now() - start;
+	BENCH_USE(found);
+
+	sprintf(variant, "vector_bsearch, %d elements", SEARCH_SIZE);
+	bench_report("vector search", variant, (double)time / SEARCHES / 1000, "ns/op");
+
+	vector_destroy(vector);
+}
+
+int main(int argc, char** argv) {
+	sort(0);
+	for(size_t threads = 1; threads <= 8; threads *= 2)
+		sort(threads);
+
+	search();
+	return 0;
+}
@@ -0,0 +1,102 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <sched.h>
+#include <pthread.h>
+#include "wsdeque.h"
+#include "bench.h"
+
+#define WORKERS		8
+#define DEPTH		16		// 2^17 - 1 tasks
+#define WORK		2000		// spins per task
+
+// A tiny fork-join scheduler: a task of depth d spawns two tasks of depth d - 1
+
+typedef struct {
+	WSDeque*	deque;
+	int		id;
+	uint64_t	executed;
+	uint64_t	stolen;
+} Worker;
+
+static Worker workers[WORKERS];
+static int count;
+static uint64_t remaining;
+
+static void execute(Worker* worker, uintptr_t depth) {
+	for(volatile int i = 0; i < WORK; i++);
+
+	if(depth > 1) {
+		wsdeque_push(worker->deque, (void*)(depth - 1));
+		wsdeque_push(worker->deque, (void*)(depth - 1));
+	}
+	worker->executed++;
+	__atomic_fetch_sub(&remaining, 1, __ATOMIC_RELAXED);
+}
+
+static void* run(void* arg) {
+	Worker* worker = arg;
+	uint64_t victim = worker->id;
+
+	while(__atomic_load_n(&remaining, __ATOMIC_RELAXED) > 0) {
+		void* task = wsdeque_pop(worker->deque);
+		if(!task && count > 1) {
+			victim = (victim * 6364136223846793005UL + 1442695040888963407UL);
+			Worker* other = &workers[(victim >> 33) % count];
+			if(other != worker && (task = wsdeque_steal(other->deque)))
+				worker->stolen++;
+		}
+
+		if(task)
+			execute(worker, (uintptr_t)task);
+		else
+			sched_yield();
+	}
+
+	return NULL;
+}
+
+static void schedule(int workers_count) {
+	count = workers_count;
+	remaining = (1UL << (DEPTH + 1)) - 1;
+	for(int i = 0; i < count; i++) {
+		workers[i].deque = wsdeque_create(64, NULL);
+		workers[i].id = i;
+		workers[i].executed = 0;
+		workers[i].stolen = 0;
+	}
+
+	// Every task starts on worker 0, the others only get work by stealing
+	wsdeque_push(workers[0].deque, (void*)(uintptr_t)(DEPTH + 1));
+
+	pthread_t threads[WORKERS];
+	uint64_t start = bench_now();
+	for(int i = 1; i < count; i++)
+		pthread_create(&threads[i], NULL, run, &workers[i]);
+	run(&workers[0]);
+	for(int i = 1; i < count; i++)
+		pthread_join(threads[i], NULL);
+	uint64_t time = bench_now() - start;
+
+	uint64_t min = UINT64_MAX, max = 0, stolen = 0;
+	for(int i = 0; i < count; i++) {
+		min = workers[i].executed < min ? workers[i].executed : min;
+		max = workers[i].executed > max ? workers[i].executed : max;
+		stolen += workers[i].stolen;
+		wsdeque_destroy(workers[i].deque);
+	}
+
+	char variant[64];
+	sprintf(variant, "%d workers, time", count);
+	bench_report("wsdeque", variant, (double)time / 1000000, "ms");
+	sprintf(variant, "%d workers, tasks per worker min/max", count);
+	bench_report("wsdeque", variant, max ? (double)min / max : 0, "ratio");
+	sprintf(variant, "%d workers, stolen tasks", count);
+	bench_report("wsdeque", variant, stolen, "tasks");
+}
+
+int main(int argc, char** argv) {
+	for(int i = 1; i <= WORKERS; i *= 2)
+		schedule(i);
+
+	return 0;
+}
@@ -0,0 +1,285 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include "bfifo.h"
+
+#define SPIN_MIN	16
+#define SHORT_WAIT	10000	// ns, about the cost of a futex wait and wake pair
+
+static inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#else
+	__asm__ __volatile__("" ::: "memory");
+#endif
+}
+
+static int futex_wait(uint32_t* addr, uint32_t val, const struct timespec* timeout) {
+	return syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, val, timeout, NULL, 0);
+}
+
+static void futex_wake(uint32_t* addr, int count) {
+	syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+}
+
+static void adapt(BlockingFIFO* bfifo, uint32_t* spin, int64_t value) {
+	if(value > bfifo->spin)
+		value = bfifo->spin;
+	if(value < 0)
+		value = 0;
+
+	__atomic_store_n(spin, (uint32_t)value, __ATOMIC_RELAXED);
+}
+
+// Lock word: 0 unlocked, 1 locked, 2 locked with waiters. It spins up to twice
+// the average spins recent acquisitions took, and halves the average whenever
+// spinning did not get the lock, e.g. because the holder was preempted.
+static void lock(BlockingFIFO* bfifo) {
+	uint32_t c = 0;
+	if(__atomic_compare_exchange_n(&bfifo->lock, &c, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+		return;
+
+	uint32_t average = __atomic_load_n(&bfifo->lock_spin, __ATOMIC_RELAXED);
+	uint32_t limit = average * 2 + SPIN_MIN;
+	if(limit > bfifo->spin)
+		limit = bfifo->spin;
+
+	uint32_t i;
+	for(i = 0; i < limit; i++) {
+		cpu_relax();
+		c = 0;
+		if(__atomic_compare_exchange_n(&bfifo->lock, &c, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+			break;
+	}
+	if(i < limit) {
+		adapt(bfifo, &bfifo->lock_spin, average + ((int64_t)i - average) / 8);
+		return;
+	}
+	adapt(bfifo, &bfifo->lock_spin, average / 2);
+
+	if(c != 2)
+		c = __atomic_exchange_n(&bfifo->lock, 2, __ATOMIC_ACQUIRE);
+
+	while(c != 0) {
+		futex_wait(&bfifo->lock, 2, NULL);
+		c = __atomic_exchange_n(&bfifo->lock, 2, __ATOMIC_ACQUIRE);
+	}
+}
+
+static void unlock(BlockingFIFO* bfifo) {
+	if(__atomic_exchange_n(&bfifo->lock, 0, __ATOMIC_RELEASE) == 2)
+		futex_wake(&bfifo->lock, 1);
+}
+
+// Bump the sequence and enter the kernel only if somebody is parked on it
+static void notify(uint32_t* seq, uint32_t* waiters) {
+	__atomic_fetch_add(seq, 1, __ATOMIC_SEQ_CST);
+	if(__atomic_load_n(waiters, __ATOMIC_SEQ_CST))
+		futex_wake(seq, 1);
+}
+
+static int64_t now() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t)ts.tv_sec * 1000000000L + ts.tv_nsec;
+}
+
+// Park on seq until it changes from val, returns false if the deadline passed
+static bool park(uint32_t* seq, uint32_t val, uint32_t* waiters, int64_t deadline) {
+	struct timespec ts;
+	struct timespec* timeout = NULL;
+	if(deadline >= 0) {
+		int64_t remain = deadline - now();
+		if(remain <= 0)
+			return false;
+
+		ts.tv_sec = remain / 1000000000L;
+		ts.tv_nsec = remain % 1000000000L;
+		timeout = &ts;
+	}
+
+	__atomic_fetch_add(waiters, 1, __ATOMIC_SEQ_CST);
+	int ret = futex_wait(seq, val, timeout);
+	__atomic_fetch_sub(waiters, 1, __ATOMIC_RELAXED);
+
+	return !(ret == -1 && errno == ETIMEDOUT);
+}
+
+BlockingFIFO* bfifo_create(size_t size, void* pool) {
+	BlockingFIFO* bfifo;
+	if(posix_memalign((void**)&bfifo, 64, sizeof(BlockingFIFO)))
+		return NULL;
+
+	void* array = malloc(size * sizeof(void*));
+	if(!array) {
+		free(bfifo);
+		return NULL;
+	}
+
+	bfifo_init(bfifo, array, size);
+	bfifo->fifo.pool = pool;
+
+	return bfifo;
+}
+
+void bfifo_destroy(BlockingFIFO* bfifo) {
+	free(bfifo->fifo.array);
+	free(bfifo);
+}
+
+void bfifo_init(BlockingFIFO* bfifo, void** array, size_t size) {
+	fifo_init(&bfifo->fifo, array, size);
+	// Nobody can make progress while a waiter spins on a single CPU
+	bfifo->spin = sysconf(_SC_NPROCESSORS_ONLN) > 1 ? BFIFO_SPIN : 0;
+	bfifo->lock = 0;
+	bfifo->lock_spin = 0;
+	bfifo->pushed = 0;
+	bfifo->pop_waiters = 0;
+	bfifo->pop_spin = bfifo->spin ? SPIN_MIN : 0;
+	bfifo->popped = 0;
+	bfifo->push_waiters = 0;
+	bfifo->push_spin = bfifo->spin ? SPIN_MIN : 0;
+}
+
+void bfifo_set_spin(BlockingFIFO* bfifo, uint32_t spin) {
+	bfifo->spin = spin;
+	adapt(bfifo, &bfifo->lock_spin, bfifo->lock_spin);
+	adapt(bfifo, &bfifo->pop_spin, bfifo->pop_spin);
+	adapt(bfifo, &bfifo->push_spin, bfifo->push_spin);
+}
+
+bool bfifo_push(BlockingFIFO* bfifo, void* data) {
+	lock(bfifo);
+	bool pushed = fifo_push(&bfifo->fifo, data);
+	unlock(bfifo);
+
+	if(pushed)
+		notify(&bfifo->pushed, &bfifo->pop_waiters);
+
+	return pushed;
+}
+
+void* bfifo_pop(BlockingFIFO* bfifo) {
+	lock(bfifo);
+	bool empty = fifo_empty(&bfifo->fifo);
+	void* data = fifo_pop(&bfifo->fifo);
+	unlock(bfifo);
+
+	if(!empty)
+		notify(&bfifo->popped, &bfifo->push_waiters);
+
+	return data;
+}
+
+// A wait which ended while spinning pulls the spin count towards twice the
+// spins it took. A park shorter than a futex wait and wake pair means a bit
+// more spinning would have been cheaper, so the spin count grows, while a
+// longer park halves it as spinning is wasted on such waits.
+static void adapt_spun(BlockingFIFO* bfifo, uint32_t* spin, uint32_t count) {
+	uint32_t current = __atomic_load_n(spin, __ATOMIC_RELAXED);
+	adapt(bfifo, spin, current + ((int64_t)count * 2 - current) / 8);
+}
+
+static void adapt_parked(BlockingFIFO* bfifo, uint32_t* spin, int64_t parked) {
+	uint32_t current = __atomic_load_n(spin, __ATOMIC_RELAXED);
+	if(parked < SHORT_WAIT)
+		adapt(bfifo, spin, (int64_t)current * 2 + SPIN_MIN);
+	else
+		adapt(bfifo, spin, current / 2);
+}
+
+bool bfifo_push_wait(BlockingFIFO* bfifo, void* data, int64_t timeout) {
+	int64_t deadline = timeout > 0 ? now() + timeout : timeout;
+	uint32_t limit = __atomic_load_n(&bfifo->push_spin, __ATOMIC_RELAXED);
+	uint32_t spin = 0;
+	bool parked = false;
+
+	while(true) {
+		// Sample the sequence before trying so that a pop in between makes the park return at once
+		uint32_t seq = __atomic_load_n(&bfifo->popped, __ATOMIC_ACQUIRE);
+		if(bfifo_push(bfifo, data)) {
+			if(spin > 0 && !parked)
+				adapt_spun(bfifo, &bfifo->push_spin, spin);
+			return true;
+		}
+
+		if(timeout == 0)
+			return false;
+
+		if(spin < limit) {
+			spin++;
+			cpu_relax();
+			continue;
+		}
+
+		int64_t begin = now();
+		if(!park(&bfifo->popped, seq, &bfifo->push_waiters, deadline))
+			return bfifo_push(bfifo, data);
+
+		if(!parked) {
+			adapt_parked(bfifo, &bfifo->push_spin, now() - begin);
+			parked = true;
+		}
+	}
+}
+
+void* bfifo_pop_wait(BlockingFIFO* bfifo, int64_t timeout) {
+	int64_t deadline = timeout > 0 ? now() + timeout : timeout;
+	uint32_t limit = __atomic_load_n(&bfifo->pop_spin, __ATOMIC_RELAXED);
+	uint32_t spin = 0;
+	bool parked = false;
+
+	while(true) {
+		uint32_t seq = __atomic_load_n(&bfifo->pushed, __ATOMIC_ACQUIRE);
+
+		lock(bfifo);
+		bool empty = fifo_empty(&bfifo->fifo);
+		void* data = fifo_pop(&bfifo->fifo);
+		unlock(bfifo);
+
+		if(!empty) {
+			notify(&bfifo->popped, &bfifo->push_waiters);
+			if(spin > 0 && !parked)
+				adapt_spun(bfifo, &bfifo->pop_spin, spin);
+			return data;
+		}
+
+		if(timeout == 0)
+			return NULL;
+
+		if(spin < limit) {
+			spin++;
+			cpu_relax();
+			continue;
+		}
+
+		int64_t begin = now();
+		if(!park(&bfifo->pushed, seq, &bfifo->pop_waiters, deadline))
+			return bfifo_pop(bfifo);
+
+		if(!parked) {
+			adapt_parked(bfifo, &bfifo->pop_spin, now() - begin);
+			parked = true;
+		}
+	}
+}
+
+size_t bfifo_size(BlockingFIFO* bfifo) {
+	lock(bfifo);
+	size_t size = fifo_size(&bfifo->fifo);
+	unlock(bfifo);
+
+	return size;
+}
+
+bool bfifo_empty(BlockingFIFO* bfifo) {
+	lock(bfifo);
+	bool empty = fifo_empty(&bfifo->fifo);
+	unlock(bfifo);
+
+	return empty;
+}
@@ -0,0 +1,135 @@
+#ifndef __UTIL_BFIFO_H__
+#define __UTIL_BFIFO_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "fifo.h"
+
+/**
+ * @file
+ * Blocking First In First Out data structure for thread handoff
+ */
+
+/**
+ * Default maximum number of spins before a waiter parks on the futex. The
+ * actual spin count adapts to how long recent waits took. On a single CPU
+ * waiters park at once.
+ */
+#ifndef BFIFO_SPIN
+#define BFIFO_SPIN	1024
+#endif
+
+/**
+ * Blocking FIFO data structure. Every operation is thread-safe, so any number
+ * of producers and consumers may share one BlockingFIFO. Each futex word has
+ * its own cache line, so parked threads do not contend with the lock holder.
+ */
+typedef struct _BlockingFIFO {
+	FIFO		fifo;		///< Underlying FIFO (internal use only)
+	uint32_t	spin;		///< Maximum spin count before parking (internal use only)
+
+	uint32_t	lock __attribute__((aligned(64)));	///< Futex lock word (internal use only)
+	uint32_t	lock_spin;	///< Average spins taken to acquire the lock (internal use only)
+
+	uint32_t	pushed __attribute__((aligned(64)));	///< Futex word bumped on every push (internal use only)
+	uint32_t	pop_waiters;	///< Number of parked consumers (internal use only)
+	uint32_t	pop_spin;	///< Adaptive spin count of consumers (internal use only)
+
+	uint32_t	popped __attribute__((aligned(64)));	///< Futex word bumped on every pop (internal use only)
+	uint32_t	push_waiters;	///< Number of parked producers (internal use only)
+	uint32_t	push_spin;	///< Adaptive spin count of producers (internal use only)
+} BlockingFIFO;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Create a BlockingFIFO. bfifo_init will be called internally.
+ *
+ * @param size FIFO array size
+ * @param pool memory pool, if NULL local memory area will be used
+ * @return BlockingFIFO
+ */
+BlockingFIFO* bfifo_create(size_t size, void* pool);
+
+/**
+ * Destroy the BlockingFIFO. There must be no waiting threads.
+ */
+void bfifo_destroy(BlockingFIFO* bfifo);
+
+/**
+ * Initialize the BlockingFIFO which is not created using bfifo_create function.
+ *
+ * @param bfifo BlockingFIFO
+ * @param array array to use
+ * @param size size of the array
+ */
+void bfifo_init(BlockingFIFO* bfifo, void** array, size_t size);
+
+/**
+ * Set the maximum number of times a waiter spins before it parks on the futex.
+ *
+ * @param bfifo BlockingFIFO
+ * @param spin maximum spin count, zero parks immediately
+ */
+void bfifo_set_spin(BlockingFIFO* bfifo, uint32_t spin);
+
+/**
+ * Push an element to the BlockingFIFO without waiting.
+ *
+ * @param bfifo BlockingFIFO
+ * @param data an element to push
+ * @return true if the element is pushed
+ */
+bool bfifo_push(BlockingFIFO* bfifo, void* data);
+
+/**
+ * Pop an element from the BlockingFIFO without waiting.
+ *
+ * @param bfifo BlockingFIFO
+ * @return popped element or NULL if there is no element
+ */
+void* bfifo_pop(BlockingFIFO* bfifo);
+
+/**
+ * Push an element, waiting for available space if the BlockingFIFO is full.
+ *
+ * @param bfifo BlockingFIFO
+ * @param data an element to push
+ * @param timeout timeout in nanoseconds, negative value waits forever, zero does not wait
+ * @return true if the element is pushed, false on timeout
+ */
+bool bfifo_push_wait(BlockingFIFO* bfifo, void* data, int64_t timeout);
+
+/**
+ * Pop an element, waiting for an element if the BlockingFIFO is empty.
+ *
+ * @param bfifo BlockingFIFO
+ * @param timeout timeout in nanoseconds, negative value waits forever, zero does not wait
+ * @return popped element or NULL on timeout
+ */
+void* bfifo_pop_wait(BlockingFIFO* bfifo, int64_t timeout);
+
+/**
+ * Get the number of elements in the BlockingFIFO.
+ *
+ * @param bfifo BlockingFIFO
+ * @return number of elements
+ */
+size_t bfifo_size(BlockingFIFO* bfifo);
+
+/**
+ * Check BlockingFIFO is empty or not
+ *
+ * @param bfifo BlockingFIFO
+ * @return true if BlockingFIFO is empty
+ */
+bool bfifo_empty(BlockingFIFO* bfifo);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UTIL_BFIFO_H__ */
@@ -0,0 +1,205 @@
+#define _GNU_SOURCE
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "vector.h"
+#include "fvector.h"
+
+#define MAGIC			0x726f746365766674UL	// "tfvector"
+
+#define LENGTH(fvector, capacity)	(sizeof(FileVectorHeader) + (capacity) * (fvector)->element_size)
+#define ELEMENT(fvector, index)		((fvector)->array + (index) * (fvector)->element_size)
+
+static void attach(FileVector* fvector, void* base) {
+	fvector->header = base;
+	fvector->array = (char*)base + sizeof(FileVectorHeader);
+}
+
+// Extend the file first, then the mapping, so the mapping never exceeds the file
+static bool reallocate(FileVector* fvector, size_t capacity) {
+	size_t old_length = LENGTH(fvector, fvector->header->capacity);
+	size_t length = LENGTH(fvector, capacity);
+
+	if(ftruncate(fvector->fd, length) < 0)
+		return false;
+
+	void* base = mremap(fvector->header, old_length, length, MREMAP_MAYMOVE);
+	// The file is left larger than the header says, fvector_open copes with it
+	if(base == MAP_FAILED)
+		return false;
+
+	attach(fvector, base);
+	fvector->header->capacity = capacity;
+	return true;
+}
+
+static bool grow(FileVector* fvector, size_t required) {
+	size_t capacity = fvector->header->capacity;
+	if(required <= capacity)
+		return true;
+
+	size_t size = fvector->growth(capacity, required);
+	if(size < required)
+		size = required;
+
+	return reallocate(fvector, size);
+}
+
+FileVector* fvector_open(const char* path, size_t element_size, size_t size, void* pool) {
+	if(element_size == 0 || element_size > UINT32_MAX)
+		return NULL;
+
+	FileVector* fvector = malloc(sizeof(FileVector));
+	if(!fvector)
+		return NULL;
+
+	fvector->element_size = element_size;
+	fvector->growth = vector_growth_default;
+	fvector->pool = pool;
+
+	fvector->fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+	if(fvector->fd < 0)
+		goto failed;
+
+	struct stat st;
+	if(fstat(fvector->fd, &st) < 0)
+		goto failed;
+
+	bool created = st.st_size == 0;
+	size_t length;
+	if(created) {
+		length = LENGTH(fvector, size);
+		if(ftruncate(fvector->fd, length) < 0)
+			goto failed;
+	} else if((size_t)st.st_size < sizeof(FileVectorHeader)) {
+		goto failed;
+	} else {
+		length = st.st_size;
+	}
+
+	void* base = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fvector->fd, 0);
+	if(base == MAP_FAILED)
+		goto failed;
+
+	attach(fvector, base);
+
+	FileVectorHeader* header = fvector->header;
+	if(created) {
+		header->magic = MAGIC;
+		header->version = FVECTOR_VERSION;
+		header->element_size = element_size;
+		header->count = 0;
+		header->capacity = size;
+	} else if(header->magic != MAGIC || header->version != FVECTOR_VERSION ||
+			header->element_size != element_size || header->count > header->capacity ||
+			LENGTH(fvector, header->capacity) > length) {
+		munmap(base, length);
+		goto failed;
+	} else if(LENGTH(fvector, header->capacity) != length) {
+		// A previous grow extended the file but failed to map it
+		munmap(base, length);
+		base = mmap(NULL, LENGTH(fvector, header->capacity), PROT_READ | PROT_WRITE, MAP_SHARED, fvector->fd, 0);
+		if(base == MAP_FAILED)
+			goto failed;
+
+		attach(fvector, base);
+	}
+	fvector->count = fvector->header->count;
+
+	return fvector;
+
+failed:
+	if(fvector->fd >= 0)
+		close(fvector->fd);
+	free(fvector);
+	return NULL;
+}
+
+void fvector_close(FileVector* fvector) {
+	fvector->header->count = fvector->count;
+	munmap(fvector->header, LENGTH(fvector, fvector->header->capacity));
+	close(fvector->fd);
+	free(fvector);
+}
+
+// The count in the header only changes here, after the elements it covers
+// are flushed, so the file never holds a count newer than its elements
+bool fvector_checkpoint(FileVector* fvector, bool wait) {
+	int flags = wait ? MS_SYNC : MS_ASYNC;
+	if(msync(fvector->header, LENGTH(fvector, fvector->count), flags) < 0)
+		return false;
+
+	fvector->header->count = fvector->count;
+	return msync(fvector->header, sizeof(FileVectorHeader), flags) == 0;
+}
+
+void fvector_set_growth(FileVector* fvector, size_t(*growth)(size_t size, size_t required)) {
+	fvector->growth = growth ? growth : vector_growth_default;
+}
+
+bool fvector_reserve(FileVector* fvector, size_t capacity) {
+	if(capacity <= fvector->header->capacity)
+		return true;
+
+	return reallocate(fvector, capacity);
+}
+
+bool fvector_is_empty(FileVector* fvector) {
+	return fvector->count == 0;
+}
+
+bool fvector_add(FileVector* fvector, const void* element) {
+	// element may point into the mapping, which moves when it grows
+	uintptr_t offset = (uintptr_t)element - (uintptr_t)fvector->array;
+	bool inside = offset < fvector->count * fvector->element_size;
+
+	void* slot = fvector_add_slot(fvector);
+	if(!slot)
+		return false;
+
+	memcpy(slot, inside ? fvector->array + offset : element, fvector->element_size);
+	return true;
+}
+
+void* fvector_add_slot(FileVector* fvector) {
+	size_t count = fvector->count;
+	if(count >= fvector->header->capacity && !grow(fvector, count + 1))
+		return NULL;
+
+	fvector->count = count + 1;
+	return ELEMENT(fvector, count);
+}
+
+void* fvector_get(FileVector* fvector, size_t index) {
+	if(index >= fvector->count)
+		return NULL;
+	else
+		return ELEMENT(fvector, index);
+}
+
+bool fvector_remove_last(FileVector* fvector, void* element) {
+	if(fvector->count == 0)
+		return false;
+
+	fvector->count--;
+	if(element)
+		memcpy(element, ELEMENT(fvector, fvector->count), fvector->element_size);
+	return true;
+}
+
+void fvector_clear(FileVector* fvector) {
+	fvector->count = 0;
+}
+
+size_t fvector_size(FileVector* fvector) {
+	return fvector->count;
+}
+
+size_t fvector_capacity(FileVector* fvector) {
+	return fvector->header->capacity;
+}
@@ -0,0 +1,175 @@
+#ifndef __UTIL_FVECTOR_H__
+#define __UTIL_FVECTOR_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @file
+ * Array wrapper data structure which is stored in a memory mapped file
+ *
+ * Elements are stored inline like TypedVector, right after a small header in
+ * the file. Reopening the file maps the elements back without rebuilding
+ * them. Elements must not contain pointers as the mapping address changes
+ * between processes.
+ *
+ * The number of elements is kept in memory and written to the file header
+ * only by fvector_checkpoint and fvector_close. A waiting checkpoint flushes
+ * the elements before the header, so after a system crash the file holds the
+ * count of the last such checkpoint and the elements it covered. Elements
+ * modified since then may show either contents.
+ */
+
+/**
+ * Version of the file layout, a file of other version can not be opened.
+ */
+#define FVECTOR_VERSION		1
+
+/**
+ * File header of FileVector (internal use only)
+ */
+typedef struct _FileVectorHeader {
+	uint64_t	magic;		///< Magic number
+	uint32_t	version;	///< File layout version
+	uint32_t	element_size;	///< Size of an element in bytes
+	uint64_t	count;		///< Number of elements as of the last checkpoint
+	uint64_t	capacity;	///< Number of elements the file can hold
+} __attribute__((aligned(64))) FileVectorHeader;
+
+/**
+ * File backed Vector data structure
+ */
+typedef struct _FileVector {
+	FileVectorHeader*	header;		///< Mapped file header (internal use only)
+	char*		array;		///< Mapped elements (internal use only)
+	size_t		count;		///< Number of elements (internal use only)
+	size_t		element_size;	///< Size of an element in bytes (internal use only)
+	int		fd;		///< File descriptor (internal use only)
+	size_t		(*growth)(size_t size, size_t required);	///< Growth policy (internal use only)
+	void*		pool;		///< Memory pool (internal use only)
+} FileVector;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Open a FileVector. The file is created if it does not exist, otherwise its
+ * elements are mapped as they are.
+ *
+ * @param path file path
+ * @param element_size size of an element in bytes
+ * @param size number of elements to allocate when the file is created
+ * @param pool memory pool to use, if NULL local memory area will be used
+ * @return FileVector or NULL if the file can not be mapped or has different version or element size
+ */
+FileVector* fvector_open(const char* path, size_t element_size, size_t size, void* pool);
+
+/**
+ * Close the FileVector. The number of elements is stored in the header and
+ * modifications are written back by the kernel even without
+ * fvector_checkpoint, but are not durable against a system crash.
+ *
+ * @param fvector FileVector
+ */
+void fvector_close(FileVector* fvector);
+
+/**
+ * Flush modified elements to the file, then publish the number of elements
+ * to the header and flush it.
+ *
+ * @param fvector FileVector
+ * @param wait if true, wait for each write to finish, otherwise just schedule them without ordering
+ * @return true if flushed
+ */
+bool fvector_checkpoint(FileVector* fvector, bool wait);
+
+/**
+ * Set the growth policy. See vector_set_growth.
+ *
+ * @param fvector FileVector
+ * @param growth growth policy, if NULL vector_growth_default will be used
+ */
+void fvector_set_growth(FileVector* fvector, size_t(*growth)(size_t size, size_t required));
+
+/**
+ * Make sure the FileVector can hold the number of elements without growing the file.
+ *
+ * @param fvector FileVector
+ * @param capacity number of elements to hold
+ * @return false if the file can not be extended
+ */
+bool fvector_reserve(FileVector* fvector, size_t capacity);
+
+/**
+ * Check the FileVector is empty or not.
+ *
+ * @param fvector FileVector
+ * @return true if the FileVector is empty
+ */
+bool fvector_is_empty(FileVector* fvector);
+
+/**
+ * Add an element to the FileVector by copying it.
+ *
+ * @param fvector FileVector
+ * @param element pointer to the element to copy
+ * @return true if the element is added
+ */
+bool fvector_add(FileVector* fvector, const void* element);
+
+/**
+ * Add an uninitialized element to the FileVector to be filled in place.
+ *
+ * @param fvector FileVector
+ * @return pointer to the new element or NULL if the file can not be extended
+ */
+void* fvector_add_slot(FileVector* fvector);
+
+/**
+ * Get an element from the FileVector.
+ *
+ * @param fvector FileVector
+ * @param index element index
+ * @return pointer to the element or NULL if index is out of bounds. It is valid until the FileVector grows.
+ */
+void* fvector_get(FileVector* fvector, size_t index);
+
+/**
+ * Remove last element from the FileVector.
+ *
+ * @param fvector FileVector
+ * @param element buffer to copy the removed element, can be NULL
+ * @return true if the element is removed
+ */
+bool fvector_remove_last(FileVector* fvector, void* element);
+
+/**
+ * Remove all elements from the FileVector. The file keeps its size.
+ *
+ * @param fvector FileVector
+ */
+void fvector_clear(FileVector* fvector);
+
+/**
+ * Get the number of elements of the FileVector.
+ *
+ * @param fvector FileVector
+ * @return size of the FileVector
+ */
+size_t fvector_size(FileVector* fvector);
+
+/**
+ * Get the capacity of the FileVector.
+ *
+ * @param fvector FileVector
+ * @return capacity size of the FileVector
+ */
+size_t fvector_capacity(FileVector* fvector);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UTIL_FVECTOR_H__ */
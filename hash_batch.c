@@ -0,0 +1,50 @@
+#include <stddef.h>
+#include "hash_batch.h"
+
+size_t hash_batch_lookup(List** table, size_t capacity, uint64_t(*hash)(void*), bool(*equals)(void*,void*), void** keys, void** entries, size_t count) {
+	List* lists[count];
+	size_t indexes[count];
+
+	// Each stage prefetches what the next stage reads, so the misses of a group overlap
+	for(size_t i = 0; i < count; i++) {
+		indexes[i] = hash(keys[i]) % capacity;
+		__builtin_prefetch(&table[indexes[i]]);
+	}
+
+	for(size_t i = 0; i < count; i++) {
+		lists[i] = table[indexes[i]];
+		if(lists[i])
+			__builtin_prefetch(lists[i]);
+	}
+
+	// A bucket is never an empty List, so its head is a node
+	for(size_t i = 0; i < count; i++) {
+		if(lists[i])
+			__builtin_prefetch(lists[i]->head);
+	}
+
+	for(size_t i = 0; i < count; i++) {
+		if(lists[i])
+			__builtin_prefetch(lists[i]->head->data);
+	}
+
+	size_t found = 0;
+	for(size_t i = 0; i < count; i++) {
+		entries[i] = NULL;
+		if(!lists[i])
+			continue;
+
+		ListIterator iter;
+		list_iterator_init(&iter, lists[i]);
+		while(list_iterator_has_next(&iter)) {
+			void* entry = list_iterator_next(&iter);
+			if(equals(*(void**)entry, keys[i])) {
+				entries[i] = entry;
+				found++;
+				break;
+			}
+		}
+	}
+
+	return found;
+}
@@ -0,0 +1,43 @@
+#ifndef __UTIL_HASH_BATCH_H__
+#define __UTIL_HASH_BATCH_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "list.h"
+
+/**
+ * @file
+ * Prefetch pipelined lookup shared by map_get_batch and set_contains_batch (internal use only)
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Look up a group of keys in a table of bucket lists. All keys are hashed and
+ * their buckets are prefetched step by step before any of them is compared,
+ * so the memory stalls of the group overlap instead of adding up.
+ *
+ * A bucket must be NULL or a non-empty List, as Map and Set destroy a bucket
+ * once its last entry is removed: the head node of every bucket is
+ * dereferenced without checking. The key compared is the first field of an
+ * entry, MapEntry.key or SetEntry.data.
+ *
+ * @param table bucket lists
+ * @param capacity number of buckets
+ * @param hash key hashing function
+ * @param equals key comparing function
+ * @param keys keys to look up
+ * @param entries array to store the entry of each key or NULL if there is no such entry
+ * @param count number of keys, the group size of the caller
+ * @return number of entries found
+ */
+size_t hash_batch_lookup(List** table, size_t capacity, uint64_t(*hash)(void*), bool(*equals)(void*,void*), void** keys, void** entries, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UTIL_HASH_BATCH_H__ */
@@ -1,6 +1,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include "map.h"
+#include "hash_batch.h"
 
 // TODO: Change accessing list using index to using iterator.
 
@@ -66,52 +67,89 @@ bool map_is_empty(Map* map) {
 	return map->size == 0;
 }
 
-bool map_put(Map* map, void* key, void* data) {
-	if(map->size + 1 > map->threshold) {
-		// Create new map
-		Map map2;
-		size_t capacity = map->capacity * 2;
-		map2.table = malloc(sizeof(List*) * capacity);
-		if(!map2.table)
-			return false;
-		bzero(map2.table, sizeof(List*) * capacity);
-		map2.capacity = capacity;
-		map2.threshold = THRESHOLD(capacity);
-		map2.size = 0;
-		map2.hash = map->hash;
-		map2.equals = map->equals;
-		map2.pool = map->pool;
+// Find the entry in a single pass over the bucket, iter is left on the entry to remove it
+static MapEntry* lookup(Map* map, uint64_t hash, void* key, ListIterator* iter) {
+	List* list = map->table[hash % map->capacity];
+	if(!list)
+		return NULL;
+	
+	list_iterator_init(iter, list);
+	while(list_iterator_has_next(iter)) {
+		MapEntry* entry = list_iterator_next(iter);
+		if(map->equals(entry->key, key))
+			return entry;
+	}
+	
+	return NULL;
+}
+
+static void remove_entry(Map* map, uint64_t hash, ListIterator* iter) {
+	size_t index = hash % map->capacity;
+	MapEntry* entry = list_iterator_remove(iter);
+	free(entry);
+	
+	if(list_is_empty(map->table[index])) {
+		list_destroy(map->table[index]);
+		map->table[index] = NULL;
+	}
+	
+	map->size--;
+}
+
+static void destroy_lists(List** table, size_t capacity) {
+	for(size_t i = 0; i < capacity; i++)
+		if(table[i])
+			list_destroy(table[i]);
+	
+	free(table);
+}
+
+// Entries are moved, not copied, so pointers to them stay valid while the table grows
+static bool extend(Map* map) {
+	size_t capacity = map->capacity * 2;
+	List** table = malloc(sizeof(List*) * capacity);
+	if(!table)
+		return false;
+	bzero(table, sizeof(List*) * capacity);
+	
+	for(size_t i = 0; i < map->capacity; i++) {
+		List* list = map->table[i];
+		if(!list)
+			continue;
 		
-		// Copy
-		MapIterator iter;
-		map_iterator_init(&iter, map);
-		while(map_iterator_has_next(&iter)) {
-			MapEntry* entry = map_iterator_next(&iter);
-			if(!map_put(&map2, entry->key, entry->data)) {
-				destroy(&map2);
+		ListIterator iter;
+		list_iterator_init(&iter, list);
+		while(list_iterator_has_next(&iter)) {
+			MapEntry* entry = list_iterator_next(&iter);
+			size_t index = map->hash(entry->key) % capacity;
+			if(!table[index])
+				table[index] = list_create(map->pool);
+			
+			if(!table[index] || !list_add(table[index], entry)) {
+				destroy_lists(table, capacity);
 				return false;
 			}
 		}
-		
-		// Destory
-		destroy(map);
-		
-		// Paste
-		memcpy(map, &map2, sizeof(Map));
 	}
 	
-	size_t index = map->hash(key) % map->capacity;
+	destroy_lists(map->table, map->capacity);
+	map->table = table;
+	map->capacity = capacity;
+	map->threshold = THRESHOLD(capacity);
+	
+	return true;
+}
+
+// Add an entry which is known to be absent
+static MapEntry* add(Map* map, uint64_t hash, void* key, void* data) {
+	if(map->size + 1 > map->threshold && !extend(map))
+		return NULL;
+	
+	size_t index = hash % map->capacity;
 	if(!map->table[index]) {
 		map->table[index] = list_create(map->pool);
 		if(!map->table[index])
-			return false;
-	} else {
-		size_t size = list_size(map->table[index]);
-		for(size_t i = 0; i < size; i++) {
-			MapEntry* entry = list_get(map->table[index], i);
-			if(map->equals(entry->key, key))
-				return false;
-		}
+			return NULL;
 	}
 	
 	MapEntry* entry = malloc(sizeof(MapEntry));
@@ -120,7 +158,7 @@ bool map_put(Map* map, void* key, void* data) {
 			list_destroy(map->table[index]);
 			map->table[index] = NULL;
 		}
-		return false;
+		return NULL;
 	}
 	
 	entry->key = key;
@@ -133,11 +171,66 @@ bool map_put(Map* map, void* key, void* data) {
 			map->table[index] = NULL;
 		}
 
-		return false;
+		return NULL;
 	}
 	map->size++;
 	
-	return true;
+	return entry;
+}
+
+bool map_put(Map* map, void* key, void* data) {
+	uint64_t hash = map->hash(key);
+	ListIterator iter;
+	if(lookup(map, hash, key, &iter))
+		return false;
+	
+	return add(map, hash, key, data) != NULL;
+}
+
+MapEntry* map_get_or_insert(Map* map, void* key, void* data, bool* inserted) {
+	uint64_t hash = map->hash(key);
+	ListIterator iter;
+	MapEntry* entry = lookup(map, hash, key, &iter);
+	if(entry) {
+		if(inserted)
+			*inserted = false;
+		return entry;
+	}
+	
+	entry = add(map, hash, key, data);
+	if(inserted)
+		*inserted = entry != NULL;
+	return entry;
+}
+
+bool map_upsert(Map* map, void* key, void* data) {
+	uint64_t hash = map->hash(key);
+	ListIterator iter;
+	MapEntry* entry = lookup(map, hash, key, &iter);
+	if(entry) {
+		entry->data = data;
+		return true;
+	}
+	
+	return add(map, hash, key, data) != NULL;
+}
+
+bool map_compute(Map* map, void* key, void*(*fn)(void* key, void* data, void* context), void* context) {
+	uint64_t hash = map->hash(key);
+	ListIterator iter;
+	MapEntry* entry = lookup(map, hash, key, &iter);
+	void* data = fn(key, entry ? entry->data : NULL, context);
+	
+	if(entry) {
+		if(data)
+			entry->data = data;
+		else
+			remove_entry(map, hash, &iter);
+		
+		return true;
+	}
+	
+	return !data || add(map, hash, key, data) != NULL;
 }
 
 bool map_update(Map* map, void* key, void* data) {
@@ -234,6 +327,20 @@ void* map_remove(Map* map, void* key) {
 	return NULL;
 }
 
+size_t map_get_batch(Map* map, void** keys, void** datas, size_t count) {
+	size_t found = 0;
+	for(size_t base = 0; base < count; base += MAP_BATCH_GROUP) {
+		size_t n = count - base < MAP_BATCH_GROUP ? count - base : MAP_BATCH_GROUP;
+		void* entries[MAP_BATCH_GROUP];
+		found += hash_batch_lookup(map->table, map->capacity, map->hash, map->equals, keys + base, entries, n);
+
+		for(size_t i = 0; i < n; i++)
+			datas[base + i] = entries[i] ? ((MapEntry*)entries[i])->data : NULL;
+	}
+	
+	return found;
+}
+
 size_t map_capacity(Map* map) {
 	return map->capacity;
 }
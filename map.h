@@ -9,6 +9,13 @@
  * Hash Map data structure
  */
 
+/**
+ * Number of keys map_get_batch prefetches and looks up together
+ */
+#ifndef MAP_BATCH_GROUP
+#define MAP_BATCH_GROUP	16
+#endif
+
 /**
  * Hash map entry data structure (internal use only)
  */
@@ -71,6 +78,41 @@ bool map_is_empty(Map* map);
  */
 bool map_put(Map* map, void* key, void* data);
 
+/**
+ * Get an element, or put it if there is no element with the key, hashing the key once.
+ *
+ * @param map HashMap
+ * @param key key of element
+ * @param data data of element to put if there is no such element
+ * @param inserted if not NULL, whether the element is putted is stored, false if memory is full
+ * @return the element found or putted, or NULL if memory is full. Its data can be modified in place
+ *         until the element is removed
+ */
+MapEntry* map_get_or_insert(Map* map, void* key, void* data, bool* inserted);
+
+/**
+ * Put an element or update the data of the element with same key, hashing the key once.
+ *
+ * @param map HashMap
+ * @param key key of element
+ * @param data data of element
+ * @return true if the element is putted or updated, false if memory is full
+ */
+bool map_upsert(Map* map, void* key, void* data);
+
+/**
+ * Compute new data of an element from the current data, hashing the key once.
+ * fn is called with NULL data if there is no such element. If fn returns NULL
+ * the element is removed, otherwise it is putted or updated with the returned data.
+ *
+ * @param map HashMap
+ * @param key key of element
+ * @param fn function returning new data from the key, the current data and the context
+ * @param context context to pass to fn
+ * @return true if the map is changed as fn returned, false if memory is full
+ */
+bool map_compute(Map* map, void* key, void*(*fn)(void* key, void* data, void* context), void* context);
+
 /**
  * Update an element with new key and data.
  *
@@ -99,6 +141,20 @@ void* map_get(Map* map, void* key);
  */
 void* map_get_key(Map* map, void* key);
 
+/**
+ * Get data of many elements at once. Keys are processed in groups of
+ * MAP_BATCH_GROUP: all keys of a group are hashed and their buckets are
+ * prefetched step by step before any of them is compared, so the memory
+ * stalls of the group overlap instead of adding up.
+ *
+ * @param map HashMap
+ * @param keys keys of the elements
+ * @param datas array to store the element's data or NULL if there is no such element, for each key
+ * @param count number of keys
+ * @return number of elements found
+ */
+size_t map_get_batch(Map* map, void** keys, void** datas, size_t count);
+
 /**
  * Check there is an element.
  *
@@ -0,0 +1,146 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mpsc_ring.h"
+
+/*
+ * Chunk layout: 8-byte header followed by the data padded to 8 bytes.
+ * The header is zero until the chunk is committed, then COMMIT | length.
+ * The consumer zeroes every chunk it finishes, so free space always reads
+ * as uncommitted headers no matter where the next chunks start.
+ */
+
+#define HEADER		sizeof(uint64_t)
+#define COMMIT		((uint64_t)1 << 63)
+#define ALIGN(len)	(((len) + HEADER - 1) & ~(size_t)(HEADER - 1))
+
+static void copy_in(MPSCRing* ring, uint64_t pos, const char* data, size_t len) {
+	size_t offset = pos & (ring->size - 1);
+	size_t len1 = ring->size - offset;
+	if(len1 > len)
+		len1 = len;
+
+	memcpy(ring->buf + offset, data, len1);
+	memcpy(ring->buf, data + len1, len - len1);
+}
+
+static void copy_out(MPSCRing* ring, uint64_t pos, char* data, size_t len) {
+	size_t offset = pos & (ring->size - 1);
+	size_t len1 = ring->size - offset;
+	if(len1 > len)
+		len1 = len;
+
+	memcpy(data, ring->buf + offset, len1);
+	memcpy(data + len1, ring->buf, len - len1);
+}
+
+static void clear(MPSCRing* ring, uint64_t pos, size_t len) {
+	size_t offset = pos & (ring->size - 1);
+	size_t len1 = ring->size - offset;
+	if(len1 > len)
+		len1 = len;
+
+	memset(ring->buf + offset, 0, len1);
+	memset(ring->buf, 0, len - len1);
+}
+
+static inline uint64_t* header(MPSCRing* ring, uint64_t pos) {
+	return (uint64_t*)(ring->buf + (pos & (ring->size - 1)));
+}
+
+MPSCRing* mpsc_ring_create(size_t size, void* pool) {
+	size_t size2 = MPSC_RING_MIN_SIZE;
+	while(size2 < size)
+		size2 <<= 1;
+
+	MPSCRing* ring;
+	if(posix_memalign((void**)&ring, 64, sizeof(MPSCRing)))
+		return NULL;
+
+	char* buf = malloc(size2);
+	if(!buf) {
+		free(ring);
+		return NULL;
+	}
+
+	mpsc_ring_init(ring, buf, size2);
+	ring->pool = pool;
+
+	return ring;
+}
+
+void mpsc_ring_destroy(MPSCRing* ring) {
+	free(ring->buf);
+	free(ring);
+}
+
+bool mpsc_ring_init(MPSCRing* ring, char* buf, size_t size) {
+	// A smaller buffer could not hold a chunk header
+	if(size < MPSC_RING_MIN_SIZE)
+		return false;
+
+	size_t size2 = 1;
+	while(size2 <= size / 2)
+		size2 <<= 1;
+
+	memset(buf, 0, size2);
+
+	ring->reserve = 0;
+	ring->head = 0;
+	ring->offset = 0;
+	ring->buf = buf;
+	ring->size = size2;
+	ring->pool = NULL;
+
+	return true;
+}
+
+bool mpsc_ring_write(MPSCRing* ring, const char* data, size_t len) {
+	size_t need = HEADER + ALIGN(len);
+	if(len >= COMMIT || need > ring->size)
+		return false;
+
+	// A fetch-add cannot be rolled back when the ring is full, so reserve with a CAS
+	uint64_t pos = __atomic_load_n(&ring->reserve, __ATOMIC_RELAXED);
+	do {
+		uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+		if(pos + need > head + ring->size)
+			return false;
+	} while(!__atomic_compare_exchange_n(&ring->reserve, &pos, pos + need, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+	copy_in(ring, pos + HEADER, data, len);
+	__atomic_store_n(header(ring, pos), COMMIT | len, __ATOMIC_RELEASE);
+
+	return true;
+}
+
+size_t mpsc_ring_read(MPSCRing* ring, char* data, size_t len) {
+	size_t read = 0;
+	while(read < len) {
+		uint64_t value = __atomic_load_n(header(ring, ring->head), __ATOMIC_ACQUIRE);
+		if(!(value & COMMIT))
+			break;
+
+		size_t chunk = value & ~COMMIT;
+		size_t len1 = chunk - ring->offset;
+		if(len1 > len - read)
+			len1 = len - read;
+
+		copy_out(ring, ring->head + HEADER + ring->offset, data + read, len1);
+		ring->offset += len1;
+		read += len1;
+
+		if(ring->offset == chunk) {
+			size_t total = HEADER + ALIGN(chunk);
+			clear(ring, ring->head, total);
+			__atomic_store_n(&ring->head, ring->head + total, __ATOMIC_RELEASE);
+			ring->offset = 0;
+		}
+	}
+
+	return read;
+}
+
+bool mpsc_ring_empty(MPSCRing* ring) {
+	return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) == __atomic_load_n(&ring->reserve, __ATOMIC_ACQUIRE);
+}
@@ -0,0 +1,97 @@
+#ifndef __UTIL_MPSC_RING_H__
+#define __UTIL_MPSC_RING_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @file
+ * Multiple producer single consumer ring buffer for strings
+ *
+ * Each write reserves a chunk atomically, copies its data without any lock and
+ * publishes the chunk by setting the commit flag in the chunk header. Chunks
+ * are read in reservation order, a chunk which is not committed yet holds
+ * back the following ones.
+ */
+
+/**
+ * Minimum buffer size, a chunk header and 8 bytes of data
+ */
+#define MPSC_RING_MIN_SIZE	16
+
+/**
+ * Multiple producer single consumer ring buffer data structure
+ */
+typedef struct _MPSCRing {
+	uint64_t	reserve __attribute__((aligned(64)));	///< Reservation index, shared by producers (internal use only)
+
+	uint64_t	head __attribute__((aligned(64)));	///< Read index of the current chunk (internal use only)
+	size_t		offset;		///< Bytes already read in the current chunk (internal use only)
+
+	char*		buf __attribute__((aligned(64)));	///< Buffer (internal use only)
+	size_t		size;		///< Buffer size, power of two (internal use only)
+	void*		pool;		///< Memory pool (internal use only)
+} MPSCRing;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Create a MPSCRing. mpsc_ring_init will be called internally.
+ *
+ * @param size buffer size, it will be rounded up to power of two and at least MPSC_RING_MIN_SIZE
+ * @param pool memory pool, if NULL local memory area will be used
+ * @return MPSCRing
+ */
+MPSCRing* mpsc_ring_create(size_t size, void* pool);
+
+/**
+ * Destroy the MPSCRing.
+ */
+void mpsc_ring_destroy(MPSCRing* ring);
+
+/**
+ * Initialize the MPSCRing which is not created using mpsc_ring_create function.
+ *
+ * @param ring MPSCRing
+ * @param buf buffer to use, it must be aligned to 8 bytes
+ * @param size buffer size, at least MPSC_RING_MIN_SIZE, only the largest power of two not exceeding it will be used
+ * @return false if size is less than MPSC_RING_MIN_SIZE
+ */
+bool mpsc_ring_init(MPSCRing* ring, char* buf, size_t size);
+
+/**
+ * Write string to the MPSCRing. Any thread.
+ *
+ * @param ring MPSCRing
+ * @param data string to write
+ * @param len string length
+ * @return true if the whole string is written, false if there is not enough space and nothing is written
+ */
+bool mpsc_ring_write(MPSCRing* ring, const char* data, size_t len);
+
+/**
+ * Read string from the MPSCRing. Consumer thread only.
+ *
+ * @param ring MPSCRing
+ * @param data string buffer to read
+ * @param len string buffer length
+ * @return read length
+ */
+size_t mpsc_ring_read(MPSCRing* ring, char* data, size_t len);
+
+/**
+ * Check MPSCRing is empty or not
+ *
+ * @param ring MPSCRing
+ * @return true if there is no reserved chunk
+ */
+bool mpsc_ring_empty(MPSCRing* ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UTIL_MPSC_RING_H__ */
@@ -0,0 +1,244 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pqueue.h"
+
+/*
+ * handles[] is a permutation of [0, size): slots below count hold live handles,
+ * slots above count hold free handles to be given out by the next pushes.
+ * positions[] is its inverse, so every handle always maps to a slot.
+ */
+
+static inline void place(PriorityQueue* pqueue, size_t pos, PriorityQueueEntry* entry, size_t handle) {
+	pqueue->array[pos] = *entry;
+	pqueue->handles[pos] = handle;
+	pqueue->positions[handle] = pos;
+}
+
+static void sift_up(PriorityQueue* pqueue, size_t pos) {
+	PriorityQueueEntry entry = pqueue->array[pos];
+	size_t handle = pqueue->handles[pos];
+
+	while(pos > 0) {
+		size_t parent = (pos - 1) / PQUEUE_ARITY;
+		if(pqueue->array[parent].priority <= entry.priority)
+			break;
+
+		place(pqueue, pos, &pqueue->array[parent], pqueue->handles[parent]);
+		pos = parent;
+	}
+
+	place(pqueue, pos, &entry, handle);
+}
+
+static void sift_down(PriorityQueue* pqueue, size_t pos) {
+	PriorityQueueEntry entry = pqueue->array[pos];
+	size_t handle = pqueue->handles[pos];
+
+	while(true) {
+		size_t first = pos * PQUEUE_ARITY + 1;
+		if(first >= pqueue->count)
+			break;
+
+		size_t last = first + PQUEUE_ARITY;
+		if(last > pqueue->count)
+			last = pqueue->count;
+
+		size_t min = first;
+		for(size_t child = first + 1; child < last; child++)
+			if(pqueue->array[child].priority < pqueue->array[min].priority)
+				min = child;
+
+		if(pqueue->array[min].priority >= entry.priority)
+			break;
+
+		place(pqueue, pos, &pqueue->array[min], pqueue->handles[min]);
+		pos = min;
+	}
+
+	place(pqueue, pos, &entry, handle);
+}
+
+static void* remove_at(PriorityQueue* pqueue, size_t pos) {
+	size_t handle = pqueue->handles[pos];
+	void* data = pqueue->array[pos].data;
+	size_t last = --pqueue->count;
+
+	if(pos != last) {
+		place(pqueue, pos, &pqueue->array[last], pqueue->handles[last]);
+		pqueue->handles[last] = handle;
+		pqueue->positions[handle] = last;
+
+		if(pos > 0 && pqueue->array[(pos - 1) / PQUEUE_ARITY].priority > pqueue->array[pos].priority)
+			sift_up(pqueue, pos);
+		else
+			sift_down(pqueue, pos);
+	}
+
+	return data;
+}
+
+static inline bool is_valid(PriorityQueue* pqueue, size_t handle) {
+	return handle < pqueue->size && pqueue->positions[handle] < pqueue->count;
+}
+
+PriorityQueue* pqueue_create(size_t size, void* pool) {
+	PriorityQueue* pqueue = malloc(sizeof(PriorityQueue));
+	if(!pqueue)
+		return NULL;
+
+	PriorityQueueEntry* array = malloc(size * sizeof(PriorityQueueEntry));
+	if(!array) {
+		free(pqueue);
+		return NULL;
+	}
+
+	size_t* index = malloc(size * 2 * sizeof(size_t));
+	if(!index) {
+		free(array);
+		free(pqueue);
+		return NULL;
+	}
+
+	pqueue_init(pqueue, array, index, size);
+	pqueue->pool = pool;
+
+	return pqueue;
+}
+
+void pqueue_destroy(PriorityQueue* pqueue) {
+	free(pqueue->array);
+	free(pqueue->handles);
+	free(pqueue);
+}
+
+bool pqueue_resize(PriorityQueue* pqueue, size_t size) {
+	if(size < pqueue->size)
+		return false;
+
+	PriorityQueueEntry* array = malloc(size * sizeof(PriorityQueueEntry));
+	if(!array)
+		return false;
+
+	size_t* index = malloc(size * 2 * sizeof(size_t));
+	if(!index) {
+		free(array);
+		return false;
+	}
+
+	memcpy(array, pqueue->array, pqueue->count * sizeof(PriorityQueueEntry));
+	memcpy(index, pqueue->handles, pqueue->size * sizeof(size_t));
+
+	size_t* positions = index + size;
+	for(size_t handle = pqueue->size; handle < size; handle++)
+		index[handle] = handle;
+
+	for(size_t pos = 0; pos < size; pos++)
+		positions[index[pos]] = pos;
+
+	free(pqueue->array);
+	free(pqueue->handles);
+
+	pqueue->array = array;
+	pqueue->handles = index;
+	pqueue->positions = positions;
+	pqueue->size = size;
+
+	return true;
+}
+
+void pqueue_init(PriorityQueue* pqueue, PriorityQueueEntry* array, size_t* index, size_t size) {
+	pqueue->count = 0;
+	pqueue->size = size;
+	pqueue->array = array;
+	pqueue->handles = index;
+	pqueue->positions = index + size;
+	pqueue->pool = NULL;
+
+	for(size_t i = 0; i < size; i++) {
+		pqueue->handles[i] = i;
+		pqueue->positions[i] = i;
+	}
+}
+
+size_t pqueue_push(PriorityQueue* pqueue, uint64_t priority, void* data) {
+	if(pqueue->count >= pqueue->size)
+		return -1;
+
+	size_t pos = pqueue->count++;
+	size_t handle = pqueue->handles[pos];
+	pqueue->array[pos].priority = priority;
+	pqueue->array[pos].data = data;
+
+	sift_up(pqueue, pos);
+
+	return handle;
+}
+
+void* pqueue_pop(PriorityQueue* pqueue) {
+	if(pqueue->count == 0)
+		return NULL;
+
+	return remove_at(pqueue, 0);
+}
+
+PriorityQueueEntry* pqueue_peek(PriorityQueue* pqueue) {
+	if(pqueue->count == 0)
+		return NULL;
+
+	return &pqueue->array[0];
+}
+
+bool pqueue_decrease(PriorityQueue* pqueue, size_t handle, uint64_t priority) {
+	if(!is_valid(pqueue, handle))
+		return false;
+
+	size_t pos = pqueue->positions[handle];
+	if(priority > pqueue->array[pos].priority)
+		return false;
+
+	pqueue->array[pos].priority = priority;
+	sift_up(pqueue, pos);
+
+	return true;
+}
+
+void* pqueue_remove(PriorityQueue* pqueue, size_t handle) {
+	if(!is_valid(pqueue, handle))
+		return NULL;
+
+	return remove_at(pqueue, pqueue->positions[handle]);
+}
+
+bool pqueue_heapify(PriorityQueue* pqueue, const PriorityQueueEntry* entries, size_t count) {
+	if(count > pqueue->size - pqueue->count)
+		return false;
+
+	memcpy(&pqueue->array[pqueue->count], entries, count * sizeof(PriorityQueueEntry));
+	pqueue->count += count;
+
+	// Floyd's bottom-up construction from the last parent
+	if(pqueue->count > 1) {
+		size_t pos = (pqueue->count - 2) / PQUEUE_ARITY + 1;
+		while(pos-- > 0)
+			sift_down(pqueue, pos);
+	}
+
+	return true;
+}
+
+size_t pqueue_size(PriorityQueue* pqueue) {
+	return pqueue->count;
+}
+
+size_t pqueue_capacity(PriorityQueue* pqueue) {
+	return pqueue->size;
+}
+
+bool pqueue_available(PriorityQueue* pqueue) {
+	return pqueue->count < pqueue->size;
+}
+
+bool pqueue_empty(PriorityQueue* pqueue) {
+	return pqueue->count == 0;
+}
@@ -0,0 +1,169 @@
+#ifndef __UTIL_PQUEUE_H__
+#define __UTIL_PQUEUE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @file
+ * Priority Queue data structure (d-ary min heap)
+ */
+
+/**
+ * Number of children per heap node. Compared to a binary heap the tree has half
+ * the levels, and the children of a node sit in 64 contiguous bytes, so sifting down
+ * touches fewer cache lines.
+ */
+#define PQUEUE_ARITY	4
+
+/**
+ * Priority queue entry data structure
+ */
+typedef struct _PriorityQueueEntry {
+	uint64_t	priority;	///< Priority, lower value is popped first
+	void*		data;		///< User data
+} PriorityQueueEntry;
+
+/**
+ * Priority Queue data structure
+ */
+typedef struct _PriorityQueue {
+	size_t			count;		///< Number of elements (internal use only)
+	size_t			size;		///< Array size (internal use only)
+	PriorityQueueEntry*	array;		///< Heap array (internal use only)
+	size_t*			handles;	///< Handle of each heap slot (internal use only)
+	size_t*			positions;	///< Heap slot of each handle (internal use only)
+	void*			pool;		///< Memory pool (internal use only)
+} PriorityQueue;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Create a PriorityQueue. pqueue_init will be called internally.
+ *
+ * @param size PriorityQueue array size
+ * @param pool memory pool, if NULL local memory area will be used
+ * @return PriorityQueue
+ */
+PriorityQueue* pqueue_create(size_t size, void* pool);
+
+/**
+ * Destroy the PriorityQueue.
+ */
+void pqueue_destroy(PriorityQueue* pqueue);
+
+/**
+ * Resize the PriorityQueue. Handles of existing elements are kept.
+ *
+ * @param pqueue PriorityQueue
+ * @param size the new size, must not be less than the current size
+ * @return false if there is no more memory to allocate or size is too small
+ */
+bool pqueue_resize(PriorityQueue* pqueue, size_t size);
+
+/**
+ * Initialize the PriorityQueue which is not created using pqueue_create function.
+ *
+ * @param pqueue PriorityQueue
+ * @param array heap array to use
+ * @param index index array to use, it must have size * 2 elements
+ * @param size size of the heap array
+ */
+void pqueue_init(PriorityQueue* pqueue, PriorityQueueEntry* array, size_t* index, size_t size);
+
+/**
+ * Push an element to the PriorityQueue.
+ *
+ * @param pqueue PriorityQueue
+ * @param priority priority of the element
+ * @param data an element to push
+ * @return handle of the element or -1 if the PriorityQueue is full. The handle is valid until the element is popped or removed.
+ */
+size_t pqueue_push(PriorityQueue* pqueue, uint64_t priority, void* data);
+
+/**
+ * Pop the element with the lowest priority.
+ *
+ * @param pqueue PriorityQueue
+ * @return popped element or NULL if there is no element
+ */
+void* pqueue_pop(PriorityQueue* pqueue);
+
+/**
+ * Peek the entry with the lowest priority.
+ *
+ * @param pqueue PriorityQueue
+ * @return peeked entry or NULL if there is no element. The entry is valid until the PriorityQueue is modified.
+ */
+PriorityQueueEntry* pqueue_peek(PriorityQueue* pqueue);
+
+/**
+ * Lower the priority of an element.
+ *
+ * @param pqueue PriorityQueue
+ * @param handle handle returned by pqueue_push
+ * @param priority the new priority, must not be greater than the current one
+ * @return false if the handle is invalid or the priority is greater than the current one
+ */
+bool pqueue_decrease(PriorityQueue* pqueue, size_t handle, uint64_t priority);
+
+/**
+ * Remove an element using its handle.
+ *
+ * @param pqueue PriorityQueue
+ * @param handle handle returned by pqueue_push
+ * @return removed element or NULL if the handle is invalid
+ */
+void* pqueue_remove(PriorityQueue* pqueue, size_t handle);
+
+/**
+ * Push many entries at once and rebuild the heap in linear time.
+ * Handles of pushed entries are not reported, use pqueue_push if they are needed.
+ *
+ * @param pqueue PriorityQueue
+ * @param entries entries to push
+ * @param count number of entries
+ * @return false if there is no space for all the entries, nothing is pushed then
+ */
+bool pqueue_heapify(PriorityQueue* pqueue, const PriorityQueueEntry* entries, size_t count);
+
+/**
+ * Get the number of elements of the PriorityQueue.
+ *
+ * @param pqueue PriorityQueue
+ * @return number of elements
+ */
+size_t pqueue_size(PriorityQueue* pqueue);
+
+/**
+ * Get the capacity of the PriorityQueue.
+ *
+ * @param pqueue PriorityQueue
+ * @return capacity of the PriorityQueue
+ */
+size_t pqueue_capacity(PriorityQueue* pqueue);
+
+/**
+ * Check there is available space to push an element.
+ *
+ * @param pqueue PriorityQueue
+ * @return true if there is available space
+ */
+bool pqueue_available(PriorityQueue* pqueue);
+
+/**
+ * Check PriorityQueue is empty or not
+ *
+ * @param pqueue PriorityQueue
+ * @return true if PriorityQueue is empty
+ */
+bool pqueue_empty(PriorityQueue* pqueue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UTIL_PQUEUE_H__ */
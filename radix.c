@@ -0,0 +1,626 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "radix.h"
+
+#define NODE4			0
+#define NODE16			1
+#define NODE48			2
+#define NODE256			3
+
+#define N4(node)		((RadixNode4*)(node))
+#define N16(node)		((RadixNode16*)(node))
+#define N48(node)		((RadixNode48*)(node))
+#define N256(node)		((RadixNode256*)(node))
+
+static const size_t node_sizes[] = { sizeof(RadixNode4), sizeof(RadixNode16), sizeof(RadixNode48), sizeof(RadixNode256) };
+static const uint16_t node_capacities[] = { 4, 16, 48, 256 };
+// Shrink a little below the smaller capacity so a node does not flip on every add and remove
+static const uint16_t node_shrinks[] = { 0, 3, 12, 40 };
+
+static RadixNode* node_create(uint8_t type) {
+	RadixNode* node = calloc(1, node_sizes[type]);
+	if(!node)
+		return NULL;
+
+	node->type = type;
+	return node;
+}
+
+// Copy the header without the type into a node of another layout
+static void copy_header(RadixNode* dest, RadixNode* src) {
+	dest->prefix_len = src->prefix_len;
+	dest->count = src->count;
+	dest->has_value = src->has_value;
+	memcpy(dest->prefix, src->prefix, src->prefix_len);
+	dest->data = src->data;
+}
+
+static void sorted_arrays(RadixNode* node, uint8_t** keys, RadixNode*** children) {
+	if(node->type == NODE4) {
+		*keys = N4(node)->keys;
+		*children = N4(node)->children;
+	} else {
+		*keys = N16(node)->keys;
+		*children = N16(node)->children;
+	}
+}
+
+static RadixNode** find_child(RadixNode* node, uint8_t byte) {
+	switch(node->type) {
+		case NODE4:
+			for(size_t i = 0; i < node->count; i++) {
+				if(N4(node)->keys[i] == byte)
+					return &N4(node)->children[i];
+			}
+			return NULL;
+		case NODE16:
+			{
+#ifdef __SSE2__
+				__m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8(byte), _mm_loadu_si128((__m128i*)N16(node)->keys));
+				int mask = _mm_movemask_epi8(cmp) & ((1 << node->count) - 1);
+				if(mask)
+					return &N16(node)->children[__builtin_ctz(mask)];
+#else
+				for(size_t i = 0; i < node->count; i++) {
+					if(N16(node)->keys[i] == byte)
+						return &N16(node)->children[i];
+				}
+#endif
+				return NULL;
+			}
+		case NODE48:
+			{
+				uint8_t index = N48(node)->index[byte];
+				return index ? &N48(node)->children[index - 1] : NULL;
+			}
+		default:
+			return N256(node)->children[byte] ? &N256(node)->children[byte] : NULL;
+	}
+}
+
+// Next child in byte order from the cursor which starts at 0
+static RadixNode* next_child(RadixNode* node, size_t* cursor, uint8_t* byte) {
+	switch(node->type) {
+		case NODE4:
+		case NODE16:
+			{
+				uint8_t* keys;
+				RadixNode** children;
+				sorted_arrays(node, &keys, &children);
+				if(*cursor >= node->count)
+					return NULL;
+
+				*byte = keys[*cursor];
+				return children[(*cursor)++];
+			}
+		case NODE48:
+			while(*cursor < 256) {
+				size_t b = (*cursor)++;
+				if(N48(node)->index[b]) {
+					*byte = b;
+					return N48(node)->children[N48(node)->index[b] - 1];
+				}
+			}
+			return NULL;
+		default:
+			while(*cursor < 256) {
+				size_t b = (*cursor)++;
+				if(N256(node)->children[b]) {
+					*byte = b;
+					return N256(node)->children[b];
+				}
+			}
+			return NULL;
+	}
+}
+
+// Move the children to a node of the next or previous layout
+static RadixNode* relayout(RadixNode* node, uint8_t type) {
+	RadixNode* other = node_create(type);
+	if(!other)
+		return NULL;
+
+	copy_header(other, node);
+
+	size_t cursor = 0;
+	size_t i = 0;
+	uint8_t byte;
+	RadixNode* child;
+	while((child = next_child(node, &cursor, &byte))) {
+		switch(type) {
+			case NODE4:
+			case NODE16:
+				{
+					uint8_t* keys;
+					RadixNode** children;
+					sorted_arrays(other, &keys, &children);
+					keys[i] = byte;
+					children[i] = child;
+					break;
+				}
+			case NODE48:
+				N48(other)->index[byte] = i + 1;
+				N48(other)->children[i] = child;
+				break;
+			default:
+				N256(other)->children[byte] = child;
+		}
+		i++;
+	}
+
+	return other;
+}
+
+static bool add_child(RadixNode** ref, uint8_t byte, RadixNode* child) {
+	RadixNode* node = *ref;
+	if(node->count == node_capacities[node->type]) {
+		RadixNode* bigger = relayout(node, node->type + 1);
+		if(!bigger)
+			return false;
+
+		free(node);
+		*ref = node = bigger;
+	}
+
+	switch(node->type) {
+		case NODE4:
+		case NODE16:
+			{
+				uint8_t* keys;
+				RadixNode** children;
+				sorted_arrays(node, &keys, &children);
+
+				size_t i = 0;
+				while(i < node->count && keys[i] < byte)
+					i++;
+
+				memmove(keys + i + 1, keys + i, node->count - i);
+				memmove(children + i + 1, children + i, sizeof(RadixNode*) * (node->count - i));
+				keys[i] = byte;
+				children[i] = child;
+				break;
+			}
+		case NODE48:
+			{
+				size_t slot = 0;
+				while(N48(node)->children[slot])
+					slot++;
+
+				N48(node)->children[slot] = child;
+				N48(node)->index[byte] = slot + 1;
+				break;
+			}
+		default:
+			N256(node)->children[byte] = child;
+	}
+	node->count++;
+
+	return true;
+}
+
+static void remove_child(RadixNode** ref, uint8_t byte) {
+	RadixNode* node = *ref;
+	switch(node->type) {
+		case NODE4:
+		case NODE16:
+			{
+				uint8_t* keys;
+				RadixNode** children;
+				sorted_arrays(node, &keys, &children);
+
+				size_t i = 0;
+				while(keys[i] != byte)
+					i++;
+
+				memmove(keys + i, keys + i + 1, node->count - i - 1);
+				memmove(children + i, children + i + 1, sizeof(RadixNode*) * (node->count - i - 1));
+				break;
+			}
+		case NODE48:
+			N48(node)->children[N48(node)->index[byte] - 1] = NULL;
+			N48(node)->index[byte] = 0;
+			break;
+		default:
+			N256(node)->children[byte] = NULL;
+	}
+	node->count--;
+
+	// Keeping the bigger layout is harmless if there is no memory to shrink
+	if(node->type != NODE4 && node->count <= node_shrinks[node->type]) {
+		RadixNode* smaller = relayout(node, node->type - 1);
+		if(smaller) {
+			free(node);
+			*ref = smaller;
+		}
+	}
+}
+
+// Free a node which holds nothing, or merge it into its only child
+static void compact(RadixNode** ref) {
+	RadixNode* node = *ref;
+	if(node->has_value)
+		return;
+
+	if(node->count == 0) {
+		free(node);
+		*ref = NULL;
+		return;
+	}
+
+	if(node->count != 1)
+		return;
+
+	size_t cursor = 0;
+	uint8_t byte = 0;
+	RadixNode* child = next_child(node, &cursor, &byte);
+	if(node->prefix_len + 1 + child->prefix_len > RADIX_PREFIX_MAX)
+		return;
+
+	uint8_t prefix[RADIX_PREFIX_MAX];
+	memcpy(prefix, node->prefix, node->prefix_len);
+	prefix[node->prefix_len] = byte;
+	memcpy(prefix + node->prefix_len + 1, child->prefix, child->prefix_len);
+
+	child->prefix_len += node->prefix_len + 1;
+	memcpy(child->prefix, prefix, child->prefix_len);
+
+	*ref = child;
+	free(node);
+}
+
+static void node_destroy(RadixNode* node) {
+	size_t cursor = 0;
+	uint8_t byte;
+	RadixNode* child;
+	while((child = next_child(node, &cursor, &byte)))
+		node_destroy(child);
+
+	free(node);
+}
+
+// Nodes holding the rest of a key, split over as many nodes as the prefix length needs
+static RadixNode* chain(const uint8_t* key, size_t len, void* data) {
+	RadixNode* node = node_create(NODE4);
+	if(!node)
+		return NULL;
+
+	size_t prefix_len = len < RADIX_PREFIX_MAX ? len : RADIX_PREFIX_MAX;
+	node->prefix_len = prefix_len;
+	memcpy(node->prefix, key, prefix_len);
+
+	if(prefix_len == len) {
+		node->has_value = true;
+		node->data = data;
+		return node;
+	}
+
+	RadixNode* child = chain(key + prefix_len + 1, len - prefix_len - 1, data);
+	if(!child) {
+		free(node);
+		return NULL;
+	}
+	add_child(&node, key[prefix_len], child);
+
+	return node;
+}
+
+// Number of prefix bytes of the node matching the key
+static size_t match_prefix(RadixNode* node, const uint8_t* key, size_t len) {
+	size_t max = node->prefix_len < len ? node->prefix_len : len;
+	size_t i = 0;
+	while(i < max && node->prefix[i] == key[i])
+		i++;
+
+	return i;
+}
+
+static RadixNode* find(RadixTree* radix, const uint8_t* key, size_t len) {
+	RadixNode* node = radix->root;
+	size_t depth = 0;
+	while(node) {
+		if(match_prefix(node, key + depth, len - depth) != node->prefix_len)
+			return NULL;
+
+		depth += node->prefix_len;
+		if(depth == len)
+			return node->has_value ? node : NULL;
+
+		RadixNode** child = find_child(node, key[depth]);
+		if(!child)
+			return NULL;
+
+		node = *child;
+		depth++;
+	}
+
+	return NULL;
+}
+
+// 1 if inserted, 0 if the key exists, -1 if there is no memory
+static int insert(RadixNode** ref, const uint8_t* key, size_t len, size_t depth, void* data) {
+	RadixNode* node = *ref;
+	if(!node) {
+		*ref = chain(key + depth, len - depth, data);
+		return *ref ? 1 : -1;
+	}
+
+	size_t matched = match_prefix(node, key + depth, len - depth);
+	if(matched < node->prefix_len) {
+		// The key leaves the prefix, so the prefix splits at that byte
+		RadixNode* parent = node_create(NODE4);
+		if(!parent)
+			return -1;
+
+		RadixNode* leaf = NULL;
+		if(depth + matched < len) {
+			leaf = chain(key + depth + matched + 1, len - depth - matched - 1, data);
+			if(!leaf) {
+				free(parent);
+				return -1;
+			}
+		}
+
+		parent->prefix_len = matched;
+		memcpy(parent->prefix, node->prefix, matched);
+
+		uint8_t byte = node->prefix[matched];
+		node->prefix_len -= matched + 1;
+		memmove(node->prefix, node->prefix + matched + 1, node->prefix_len);
+		add_child(&parent, byte, node);
+
+		if(leaf) {
+			add_child(&parent, key[depth + matched], leaf);
+		} else {
+			parent->has_value = true;
+			parent->data = data;
+		}
+
+		*ref = parent;
+		return 1;
+	}
+
+	depth += node->prefix_len;
+	if(depth == len) {
+		if(node->has_value)
+			return 0;
+
+		node->has_value = true;
+		node->data = data;
+		return 1;
+	}
+
+	RadixNode** child = find_child(node, key[depth]);
+	if(child)
+		return insert(child, key, len, depth + 1, data);
+
+	RadixNode* leaf = chain(key + depth + 1, len - depth - 1, data);
+	if(!leaf)
+		return -1;
+
+	if(!add_child(ref, key[depth], leaf)) {
+		node_destroy(leaf);
+		return -1;
+	}
+
+	return 1;
+}
+
+static bool remove_key(RadixNode** ref, const uint8_t* key, size_t len, size_t depth, void** data) {
+	RadixNode* node = *ref;
+	if(match_prefix(node, key + depth, len - depth) != node->prefix_len)
+		return false;
+
+	depth += node->prefix_len;
+	if(depth == len) {
+		if(!node->has_value)
+			return false;
+
+		*data = node->data;
+		node->has_value = false;
+		node->data = NULL;
+	} else {
+		RadixNode** child = find_child(node, key[depth]);
+		if(!child || !remove_key(child, key, len, depth + 1, data))
+			return false;
+
+		if(!*child)
+			remove_child(ref, key[depth]);
+	}
+
+	compact(ref);
+	return true;
+}
+
+typedef struct _Walk {
+	uint8_t*	key;
+	size_t		len;
+	size_t		size;
+	bool		(*fn)(const void* key, size_t len, void* data, void* context);
+	void*		context;
+} Walk;
+
+static bool append(Walk* walk, const uint8_t* bytes, size_t len) {
+	if(len == 0)
+		return true;
+
+	if(walk->len + len > walk->size) {
+		size_t size = walk->size ? walk->size : 64;
+		while(size < walk->len + len)
+			size <<= 1;
+
+		uint8_t* key = realloc(walk->key, size);
+		if(!key)
+			return false;
+
+		walk->key = key;
+		walk->size = size;
+	}
+
+	memcpy(walk->key + walk->len, bytes, len);
+	walk->len += len;
+	return true;
+}
+
+static bool visit(RadixNode* node, Walk* walk) {
+	size_t mark = walk->len;
+	if(!append(walk, node->prefix, node->prefix_len))
+		return false;
+
+	if(node->has_value && !walk->fn(walk->key, walk->len, node->data, walk->context))
+		return false;
+
+	size_t cursor = 0;
+	uint8_t byte;
+	RadixNode* child;
+	while((child = next_child(node, &cursor, &byte))) {
+		if(!append(walk, &byte, 1) || !visit(child, walk))
+			return false;
+
+		walk->len--;
+	}
+	walk->len = mark;
+
+	return true;
+}
+
+RadixTree* radix_create(void* pool) {
+	RadixTree* radix = malloc(sizeof(RadixTree));
+	if(!radix)
+		return NULL;
+
+	radix->root = NULL;
+	radix->size = 0;
+	radix->pool = pool;
+
+	return radix;
+}
+
+void radix_destroy(RadixTree* radix) {
+	if(radix->root)
+		node_destroy(radix->root);
+	free(radix);
+}
+
+bool radix_is_empty(RadixTree* radix) {
+	return radix->size == 0;
+}
+
+bool radix_put(RadixTree* radix, const void* key, size_t len, void* data) {
+	if(insert(&radix->root, key, len, 0, data) <= 0)
+		return false;
+
+	radix->size++;
+	return true;
+}
+
+bool radix_update(RadixTree* radix, const void* key, size_t len, void* data) {
+	RadixNode* node = find(radix, key, len);
+	if(!node)
+		return false;
+
+	node->data = data;
+	return true;
+}
+
+void* radix_get(RadixTree* radix, const void* key, size_t len) {
+	RadixNode* node = find(radix, key, len);
+	return node ? node->data : NULL;
+}
+
+bool radix_contains(RadixTree* radix, const void* key, size_t len) {
+	return find(radix, key, len) != NULL;
+}
+
+void* radix_remove(RadixTree* radix, const void* key, size_t len) {
+	void* data;
+	if(!radix->root || !remove_key(&radix->root, key, len, 0, &data))
+		return NULL;
+
+	radix->size--;
+	return data;
+}
+
+void* radix_longest_prefix(RadixTree* radix, const void* key, size_t len, size_t* matched) {
+	const uint8_t* bytes = key;
+	RadixNode* node = radix->root;
+	RadixNode* best = NULL;
+	size_t best_len = 0;
+	size_t depth = 0;
+	while(node) {
+		if(match_prefix(node, bytes + depth, len - depth) != node->prefix_len)
+			break;
+
+		depth += node->prefix_len;
+		if(node->has_value) {
+			best = node;
+			best_len = depth;
+		}
+
+		if(depth == len)
+			break;
+
+		RadixNode** child = find_child(node, bytes[depth]);
+		if(!child)
+			break;
+
+		node = *child;
+		depth++;
+	}
+
+	if(!best)
+		return NULL;
+
+	if(matched)
+		*matched = best_len;
+
+	return best->data;
+}
+
+bool radix_iterate_prefix(RadixTree* radix, const void* prefix, size_t len, bool(*fn)(const void* key, size_t len, void* data, void* context), void* context) {
+	const uint8_t* bytes = prefix;
+	RadixNode* node = radix->root;
+	size_t depth = 0;
+
+	// Find the first node whose keys all start with the prefix
+	while(node) {
+		size_t rest = len - depth;
+		size_t matched = match_prefix(node, bytes + depth, rest);
+		if(matched == rest)
+			break;
+
+		if(matched < node->prefix_len)
+			return true;
+
+		depth += node->prefix_len;
+		RadixNode** child = find_child(node, bytes[depth]);
+		if(!child)
+			return true;
+
+		node = *child;
+		depth++;
+	}
+
+	if(!node)
+		return true;
+
+	Walk walk = { .key = NULL, .len = 0, .size = 0, .fn = fn, .context = context };
+	bool result = append(&walk, bytes, depth) && visit(node, &walk);
+	free(walk.key);
+
+	return result;
+}
+
+size_t radix_size(RadixTree* radix) {
+	return radix->size;
+}
+
+void radix_uint64_key(uint64_t value, uint8_t* key) {
+	for(int i = 7; i >= 0; i--) {
+		key[i] = value;
+		value >>= 8;
+	}
+}
@@ -0,0 +1,207 @@
+#ifndef __UTIL_RADIX_H__
+#define __UTIL_RADIX_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @file
+ * Radix Tree data structure (adaptive radix tree)
+ *
+ * Keys are byte strings which are not copied but spread over the nodes, one
+ * byte per level, with runs of single-child levels compressed into a node
+ * prefix. Each node picks the smallest of four layouts (4, 16, 48 or 256
+ * children) that fits its children. Besides exact lookup, the tree answers
+ * longest prefix match and iterates keys under a prefix in byte order.
+ *
+ * Integer keys should be converted with radix_uint64_key so that byte order
+ * is numeric order. Prefixes match on byte boundaries, e.g. an IPv4 /24
+ * route is the first 3 bytes of the address in network byte order.
+ */
+
+/**
+ * Maximum prefix length stored in a node, longer runs are split over nodes
+ */
+#ifndef RADIX_PREFIX_MAX
+#define RADIX_PREFIX_MAX	11
+#endif
+
+/**
+ * Radix tree node header (internal use only)
+ */
+typedef struct _RadixNode {
+	uint8_t		type;				///< Node layout
+	uint8_t		prefix_len;			///< Length of the compressed prefix
+	uint16_t	count;				///< Number of children
+	bool		has_value;			///< A key ends at this node
+	uint8_t		prefix[RADIX_PREFIX_MAX];	///< Compressed prefix
+	void*		data;				///< Value of the key ending at this node
+} RadixNode;
+
+/**
+ * Radix tree node with up to 4 children, keys are sorted (internal use only)
+ */
+typedef struct _RadixNode4 {
+	RadixNode	node;
+	uint8_t		keys[4];
+	RadixNode*	children[4];
+} RadixNode4;
+
+/**
+ * Radix tree node with up to 16 children, keys are sorted (internal use only)
+ */
+typedef struct _RadixNode16 {
+	RadixNode	node;
+	uint8_t		keys[16];
+	RadixNode*	children[16];
+} RadixNode16;
+
+/**
+ * Radix tree node with up to 48 children, index is slot + 1 of each byte (internal use only)
+ */
+typedef struct _RadixNode48 {
+	RadixNode	node;
+	uint8_t		index[256];
+	RadixNode*	children[48];
+} RadixNode48;
+
+/**
+ * Radix tree node with a child per byte (internal use only)
+ */
+typedef struct _RadixNode256 {
+	RadixNode	node;
+	RadixNode*	children[256];
+} RadixNode256;
+
+/**
+ * Radix Tree data structure
+ */
+typedef struct _RadixTree {
+	RadixNode*	root;		///< Root node (internal use only)
+	size_t		size;		///< Number of elements (internal use only)
+	void*		pool;		///< Memory pool (internal use only)
+} RadixTree;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Create a RadixTree.
+ *
+ * @param pool memory pool to use, if NULL local memory area will be used
+ */
+RadixTree* radix_create(void* pool);
+
+/**
+ * Destroy the RadixTree.
+ *
+ * @param radix RadixTree
+ */
+void radix_destroy(RadixTree* radix);
+
+/**
+ * Check the RadixTree is empty or not.
+ *
+ * @param radix RadixTree
+ * @return true if the RadixTree is empty
+ */
+bool radix_is_empty(RadixTree* radix);
+
+/**
+ * Put an element to the RadixTree.
+ *
+ * @param radix RadixTree
+ * @param key key of element
+ * @param len length of the key in bytes
+ * @param data data of element
+ * @return true if the element is putted, false if there is an element with same key or memory is full
+ */
+bool radix_put(RadixTree* radix, const void* key, size_t len, void* data);
+
+/**
+ * Update an element with new data.
+ *
+ * @param radix RadixTree
+ * @param key key of the element
+ * @param len length of the key in bytes
+ * @param data new data of the element
+ * @return true if the element is updated, false if there is no such element
+ */
+bool radix_update(RadixTree* radix, const void* key, size_t len, void* data);
+
+/**
+ * Get an element data from the RadixTree.
+ *
+ * @param radix RadixTree
+ * @param key key of the element
+ * @param len length of the key in bytes
+ * @return the element's data or NULL if there is no such element
+ */
+void* radix_get(RadixTree* radix, const void* key, size_t len);
+
+/**
+ * Check there is an element.
+ *
+ * @param radix RadixTree
+ * @param key key of the element
+ * @param len length of the key in bytes
+ * @return true if there is an element with the key
+ */
+bool radix_contains(RadixTree* radix, const void* key, size_t len);
+
+/**
+ * Remove an element from the RadixTree.
+ *
+ * @param radix RadixTree
+ * @param key key of the element
+ * @param len length of the key in bytes
+ * @return removed element or NULL if nothing is removed
+ */
+void* radix_remove(RadixTree* radix, const void* key, size_t len);
+
+/**
+ * Find the element with the longest key which is a prefix of the key.
+ *
+ * @param radix RadixTree
+ * @param key key to match
+ * @param len length of the key in bytes
+ * @param matched if not NULL, length of the matched key is stored
+ * @return the element's data or NULL if no key is a prefix of the key
+ */
+void* radix_longest_prefix(RadixTree* radix, const void* key, size_t len, size_t* matched);
+
+/**
+ * Call the function for each element whose key starts with the prefix, in byte order of the keys.
+ *
+ * @param radix RadixTree
+ * @param prefix prefix of the keys
+ * @param len length of the prefix in bytes, 0 to iterate all elements
+ * @param fn function to call with the key, its length, the element's data and the context, returning false to stop
+ * @param context context to pass to the function
+ * @return false if the function stopped the iteration or there is no memory to build the keys
+ */
+bool radix_iterate_prefix(RadixTree* radix, const void* prefix, size_t len, bool(*fn)(const void* key, size_t len, void* data, void* context), void* context);
+
+/**
+ * Get the number of elements of the RadixTree.
+ *
+ * @param radix RadixTree
+ * @return number of elements
+ */
+size_t radix_size(RadixTree* radix);
+
+/**
+ * Convert unsigned integer 64-bits to a key which sorts in numeric order.
+ *
+ * @param value integer
+ * @param key 8 bytes buffer to store the key
+ */
+void radix_uint64_key(uint64_t value, uint8_t* key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UTIL_RADIX_H__ */
@@ -0,0 +1,301 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include <sched.h>
+#include "map.h"
+#include "rcu_map.h"
+
+#define THRESHOLD(cap)	(((cap) >> 1) + ((cap) >> 2))	// 75%
+
+/**
+ * Epoch a reader thread is reading in, 0 if it is not reading
+ */
+typedef struct _Reader {
+	uint64_t	epoch;
+	bool		used;
+} __attribute__((aligned(64))) Reader;
+
+// Readers are shared by all maps so that a thread needs a single slot
+static Reader readers[RCU_MAP_READERS];
+static uint64_t epoch __attribute__((aligned(64))) = 1;
+
+static __thread Reader* reader;
+static pthread_key_t reader_key;
+static pthread_once_t reader_once = PTHREAD_ONCE_INIT;
+
+static void reader_release(void* slot) {
+	Reader* r = slot;
+	__atomic_store_n(&r->epoch, 0, __ATOMIC_RELEASE);
+	__atomic_store_n(&r->used, false, __ATOMIC_RELEASE);
+}
+
+static void reader_key_create() {
+	pthread_key_create(&reader_key, reader_release);
+}
+
+static Reader* reader_get() {
+	if(reader)
+		return reader;
+
+	pthread_once(&reader_once, reader_key_create);
+	for(size_t i = 0; i < RCU_MAP_READERS; i++) {
+		bool used = false;
+		if(__atomic_compare_exchange_n(&readers[i].used, &used, true, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+			if(pthread_setspecific(reader_key, &readers[i]) != 0) {
+				__atomic_store_n(&readers[i].used, false, __ATOMIC_RELEASE);
+				return NULL;
+			}
+
+			reader = &readers[i];
+			return reader;
+		}
+	}
+
+	return NULL;
+}
+
+// Lock free if the thread has a reader slot, otherwise under the writer lock
+static Reader* read_lock(RCUMap* map) {
+	Reader* r = reader_get();
+	if(!r) {
+		pthread_mutex_lock(&map->lock);
+		return NULL;
+	}
+
+	// The epoch must be visible before any pointer of the map is read
+	__atomic_store_n(&r->epoch, __atomic_load_n(&epoch, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+	return r;
+}
+
+static void read_unlock(RCUMap* map, Reader* r) {
+	if(r)
+		__atomic_store_n(&r->epoch, 0, __ATOMIC_RELEASE);
+	else
+		pthread_mutex_unlock(&map->lock);
+}
+
+// Wait until every reader which started before now has left
+static void synchronize() {
+	uint64_t target = __atomic_add_fetch(&epoch, 1, __ATOMIC_SEQ_CST);
+
+	// Pairs with the fence of read_lock: either the reader sees the unlinked
+	// pointer as gone, or its epoch is seen here by the scan
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	for(size_t i = 0; i < RCU_MAP_READERS; i++) {
+		while(true) {
+			uint64_t e = __atomic_load_n(&readers[i].epoch, __ATOMIC_ACQUIRE);
+			if(e == 0 || e >= target)
+				break;
+
+			sched_yield();
+		}
+	}
+}
+
+static RCUMapTable* table_create(size_t capacity) {
+	RCUMapTable* table = calloc(1, sizeof(RCUMapTable) + sizeof(RCUMapNode*) * capacity);
+	if(!table)
+		return NULL;
+
+	table->capacity = capacity;
+	return table;
+}
+
+static void table_destroy(RCUMapTable* table) {
+	for(size_t i = 0; i < table->capacity; i++) {
+		RCUMapNode* node = table->buckets[i];
+		while(node) {
+			RCUMapNode* next = node->next;
+			free(node);
+			node = next;
+		}
+	}
+
+	free(table);
+}
+
+static RCUMapNode* lookup(RCUMap* map, void* key) {
+	RCUMapTable* table = __atomic_load_n(&map->table, __ATOMIC_ACQUIRE);
+	size_t index = map->hash(key) % table->capacity;
+
+	RCUMapNode* node = __atomic_load_n(&table->buckets[index], __ATOMIC_ACQUIRE);
+	while(node) {
+		if(map->equals(node->key, key))
+			return node;
+
+		node = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE);
+	}
+
+	return NULL;
+}
+
+static RCUMapNode* node_create(void* key, void* data, RCUMapNode* next) {
+	RCUMapNode* node = malloc(sizeof(RCUMapNode));
+	if(!node)
+		return NULL;
+
+	node->key = key;
+	node->data = data;
+	node->next = next;
+
+	return node;
+}
+
+// Copy every node to a bigger table, readers keep the old one until it is published
+static bool extend(RCUMap* map) {
+	RCUMapTable* old = map->table;
+	RCUMapTable* table = table_create(old->capacity * 2);
+	if(!table)
+		return false;
+
+	for(size_t i = 0; i < old->capacity; i++) {
+		for(RCUMapNode* node = old->buckets[i]; node; node = node->next) {
+			size_t index = map->hash(node->key) % table->capacity;
+			RCUMapNode* copy = node_create(node->key, node->data, table->buckets[index]);
+			if(!copy) {
+				table_destroy(table);
+				return false;
+			}
+			table->buckets[index] = copy;
+		}
+	}
+
+	__atomic_store_n(&map->table, table, __ATOMIC_RELEASE);
+	map->threshold = THRESHOLD(table->capacity);
+
+	synchronize();
+	table_destroy(old);
+
+	return true;
+}
+
+RCUMap* rcu_map_create(size_t initial_capacity, uint64_t(*hash)(void*), bool(*equals)(void*,void*), void* pool) {
+	if(!equals)
+		equals = map_uint64_equals;
+
+	if(!hash)
+		hash = map_uint64_hash;
+
+	size_t capacity = 1;
+	while(capacity < initial_capacity)
+		capacity <<= 1;
+
+	RCUMap* map;
+	if(posix_memalign((void**)&map, 64, sizeof(RCUMap)) != 0)
+		return NULL;
+
+	map->table = table_create(capacity);
+	if(!map->table) {
+		free(map);
+		return NULL;
+	}
+
+	pthread_mutex_init(&map->lock, NULL);
+	map->threshold = THRESHOLD(capacity);
+	map->size = 0;
+	map->hash = hash;
+	map->equals = equals;
+	map->pool = pool;
+
+	return map;
+}
+
+void rcu_map_destroy(RCUMap* map) {
+	table_destroy(map->table);
+	pthread_mutex_destroy(&map->lock);
+	free(map);
+}
+
+bool rcu_map_is_empty(RCUMap* map) {
+	return rcu_map_size(map) == 0;
+}
+
+bool rcu_map_put(RCUMap* map, void* key, void* data) {
+	pthread_mutex_lock(&map->lock);
+
+	if(lookup(map, key) || (map->size + 1 > map->threshold && !extend(map))) {
+		pthread_mutex_unlock(&map->lock);
+		return false;
+	}
+
+	RCUMapTable* table = map->table;
+	size_t index = map->hash(key) % table->capacity;
+	RCUMapNode* node = node_create(key, data, table->buckets[index]);
+	if(!node) {
+		pthread_mutex_unlock(&map->lock);
+		return false;
+	}
+
+	__atomic_store_n(&table->buckets[index], node, __ATOMIC_RELEASE);
+	__atomic_store_n(&map->size, map->size + 1, __ATOMIC_RELAXED);
+
+	pthread_mutex_unlock(&map->lock);
+	return true;
+}
+
+void* rcu_map_update(RCUMap* map, void* key, void* data) {
+	pthread_mutex_lock(&map->lock);
+
+	RCUMapNode* node = lookup(map, key);
+	void* old = NULL;
+	if(node)
+		old = __atomic_exchange_n(&node->data, data, __ATOMIC_ACQ_REL);
+
+	pthread_mutex_unlock(&map->lock);
+	return old;
+}
+
+void rcu_map_synchronize(RCUMap* map) {
+	synchronize();
+}
+
+void* rcu_map_get(RCUMap* map, void* key) {
+	Reader* r = read_lock(map);
+
+	RCUMapNode* node = lookup(map, key);
+	void* data = node ? __atomic_load_n(&node->data, __ATOMIC_ACQUIRE) : NULL;
+
+	read_unlock(map, r);
+	return data;
+}
+
+bool rcu_map_contains(RCUMap* map, void* key) {
+	Reader* r = read_lock(map);
+
+	bool found = lookup(map, key) != NULL;
+
+	read_unlock(map, r);
+	return found;
+}
+
+void* rcu_map_remove(RCUMap* map, void* key) {
+	pthread_mutex_lock(&map->lock);
+
+	RCUMapTable* table = map->table;
+	size_t index = map->hash(key) % table->capacity;
+	RCUMapNode** link = &table->buckets[index];
+	while(*link && !map->equals((*link)->key, key))
+		link = &(*link)->next;
+
+	RCUMapNode* node = *link;
+	if(!node) {
+		pthread_mutex_unlock(&map->lock);
+		return NULL;
+	}
+
+	__atomic_store_n(link, node->next, __ATOMIC_RELEASE);
+	__atomic_store_n(&map->size, map->size - 1, __ATOMIC_RELAXED);
+
+	// Readers standing on the node can still follow its next pointer
+	synchronize();
+	void* data = node->data;
+	free(node);
+
+	pthread_mutex_unlock(&map->lock);
+	return data;
+}
+
+size_t rcu_map_size(RCUMap* map) {
+	return __atomic_load_n(&map->size, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,161 @@
+#ifndef __UTIL_RCU_MAP_H__
+#define __UTIL_RCU_MAP_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+/**
+ * @file
+ * Concurrent read-mostly Hash Map data structure
+ *
+ * Readers take no lock and write no shared state: each reader thread only
+ * writes the epoch it is reading in to its own cache line. Writers are
+ * serialized by a mutex, publish changes with atomic pointer stores and wait
+ * until every reader which may still see a removed node has left before
+ * freeing it (epoch based reclamation). Growing the table copies it, so
+ * readers keep using the old table until it is replaced.
+ */
+
+/**
+ * Maximum number of threads which read without lock at the same time, other
+ * threads read under the writer mutex
+ */
+#ifndef RCU_MAP_READERS
+#define RCU_MAP_READERS		128
+#endif
+
+/**
+ * Concurrent Hash Map node (internal use only)
+ */
+typedef struct _RCUMapNode {
+	void*			key;	///< Key
+	void*			data;	///< Value
+	struct _RCUMapNode*	next;	///< Next node of the bucket
+} RCUMapNode;
+
+/**
+ * Concurrent Hash Map table (internal use only)
+ */
+typedef struct _RCUMapTable {
+	size_t		capacity;	///< Number of buckets
+	RCUMapNode*	buckets[];	///< Buckets
+} RCUMapTable;
+
+/**
+ * Concurrent read-mostly Hash Map data structure
+ */
+typedef struct _RCUMap {
+	RCUMapTable*	table;		///< Current table (internal use only)
+
+	uint64_t(*hash)(void*);		///< hashing function
+	bool(*equals)(void*,void*);	///< comparing function
+
+	pthread_mutex_t	lock __attribute__((aligned(64)));	///< Writer lock (internal use only)
+	size_t		threshold;	///< Threshold to extend the table (internal use only)
+	size_t		size;		///< Number of elements (internal use only)
+
+	void*		pool;		///< Memory pool (internal use only)
+} RCUMap;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Create a concurrent HashMap.
+ *
+ * @param initial_capacity respected maximum number of elements
+ * @param hash key hashing function, if hash is NULL map_uint64_hash will be used
+ * @param equals key comparing function, if equals is NULL map_uint64_equals will be used
+ * @param pool memory pool to use, if NULL local memory area will be used
+ */
+RCUMap* rcu_map_create(size_t initial_capacity, uint64_t(*hash)(void*), bool(*equals)(void*,void*), void* pool);
+
+/**
+ * Destroy the concurrent HashMap. No thread may access it anymore.
+ *
+ * @param map concurrent HashMap
+ */
+void rcu_map_destroy(RCUMap* map);
+
+/**
+ * Check the concurrent HashMap is empty or not.
+ *
+ * @param map concurrent HashMap
+ * @return true if the concurrent HashMap is empty
+ */
+bool rcu_map_is_empty(RCUMap* map);
+
+/**
+ * Put an element to the concurrent HashMap.
+ *
+ * @param map concurrent HashMap
+ * @param key key of element
+ * @param data data of element
+ * @return true if the element is putted, false if there is an element with same key or memory is full
+ */
+bool rcu_map_put(RCUMap* map, void* key, void* data);
+
+/**
+ * Update an element with new data. Readers see either the old or the new data.
+ * Unlike rcu_map_remove it returns without waiting for the readers, so an
+ * rcu_map_get which started before may still return the old data. Call
+ * rcu_map_synchronize before freeing the old data.
+ *
+ * @param map concurrent HashMap
+ * @param key key of the element
+ * @param data new data of the element
+ * @return old data of the element or NULL if there is no such element
+ */
+void* rcu_map_update(RCUMap* map, void* key, void* data);
+
+/**
+ * Get an element data from the concurrent HashMap without lock.
+ *
+ * @param map concurrent HashMap
+ * @param key key of the element
+ * @return the element's data or NULL if there is no such element
+ */
+void* rcu_map_get(RCUMap* map, void* key);
+
+/**
+ * Check there is an element without lock.
+ *
+ * @param map concurrent HashMap
+ * @param key key of the element
+ * @return true if there is an element with the key
+ */
+bool rcu_map_contains(RCUMap* map, void* key);
+
+/**
+ * Remove an element from the concurrent HashMap. It waits until no reader can see the element.
+ *
+ * @param map concurrent HashMap
+ * @param key key of the element
+ * @return removed element or NULL if nothing is removed
+ */
+void* rcu_map_remove(RCUMap* map, void* key);
+
+/**
+ * Wait until every reader which started before the call has left, so data
+ * replaced by rcu_map_update can be freed. rcu_map_remove does this itself.
+ *
+ * @param map concurrent HashMap
+ */
+void rcu_map_synchronize(RCUMap* map);
+
+/**
+ * Get the number of elements of the concurrent HashMap.
+ *
+ * @param map concurrent HashMap
+ * @return number of elements
+ */
+size_t rcu_map_size(RCUMap* map);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UTIL_RCU_MAP_H__ */
@@ -0,0 +1,126 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "record_ring.h"
+
+#define RECORD		0
+#define SKIP		1
+
+#define ALIGN(len)	(((len) + RECORD_RING_ALIGN - 1) & ~(size_t)(RECORD_RING_ALIGN - 1))
+
+typedef struct {
+	uint32_t	len;	///< Record length, or length of the skipped area including the header
+	uint32_t	type;	///< RECORD or SKIP
+} RecordHeader;
+
+RecordRing* record_ring_create(size_t size, void* pool) {
+	size_t size2 = RECORD_RING_ALIGN;
+	while(size2 < size)
+		size2 <<= 1;
+
+	RecordRing* rring;
+	if(posix_memalign((void**)&rring, 64, sizeof(RecordRing)))
+		return NULL;
+
+	char* buf = malloc(size2);
+	if(!buf) {
+		free(rring);
+		return NULL;
+	}
+
+	record_ring_init(rring, buf, size2);
+	rring->ring.pool = pool;
+
+	return rring;
+}
+
+void record_ring_destroy(RecordRing* rring) {
+	free(rring->ring.buf);
+	free(rring);
+}
+
+void record_ring_init(RecordRing* rring, char* buf, size_t size) {
+	ring_init(&rring->ring, buf, size);
+	rring->reserved = 0;
+	rring->pending = 0;
+}
+
+void* record_ring_reserve(RecordRing* rring, size_t len) {
+	size_t need = ALIGN(sizeof(RecordHeader) + len);
+	if(len > UINT32_MAX || need > rring->ring.size)
+		return NULL;
+
+	struct iovec vec[2];
+	size_t skip = rring->ring.size - (rring->ring.tail & (rring->ring.size - 1));
+	if(skip < need) {
+		// Not contiguous, publish a skip marker over the tail on its own so that
+		// the record only needs need bytes at the beginning of the buffer, not
+		// skip + need which may exceed the whole buffer.
+		// Offsets are aligned, so there is always room for the skip header.
+		if(ring_write_reserve(&rring->ring, vec, skip) < skip)
+			return NULL;
+
+		RecordHeader* header = vec[0].iov_base;
+		header->len = skip;
+		header->type = SKIP;
+		ring_write_commit(&rring->ring, skip);
+	}
+
+	if(ring_write_reserve(&rring->ring, vec, need) < need)
+		return NULL;
+
+	RecordHeader* header = vec[0].iov_base;
+	header->len = len;
+	header->type = RECORD;
+	rring->reserved = need;
+
+	return header + 1;
+}
+
+void record_ring_commit(RecordRing* rring) {
+	ring_write_commit(&rring->ring, rring->reserved);
+	rring->reserved = 0;
+}
+
+bool record_ring_write(RecordRing* rring, const void* data, size_t len) {
+	void* record = record_ring_reserve(rring, len);
+	if(!record)
+		return false;
+
+	memcpy(record, data, len);
+	record_ring_commit(rring);
+
+	return true;
+}
+
+size_t record_ring_read_batch(RecordRing* rring, struct iovec* records, size_t count) {
+	Ring* ring = &rring->ring;
+	struct iovec vec[2];
+	size_t readable = ring_read_peek(ring, vec, SIZE_MAX);
+
+	size_t n = 0;
+	while(n < count && rring->pending < readable) {
+		RecordHeader* header = (RecordHeader*)(ring->buf + ((ring->head + rring->pending) & (ring->size - 1)));
+		if(header->type == SKIP) {
+			rring->pending += header->len;
+			continue;
+		}
+
+		records[n].iov_base = header + 1;
+		records[n].iov_len = header->len;
+		n++;
+
+		rring->pending += ALIGN(sizeof(RecordHeader) + header->len);
+	}
+
+	return n;
+}
+
+void record_ring_release(RecordRing* rring) {
+	ring_read_consume(&rring->ring, rring->pending);
+	rring->pending = 0;
+}
+
+bool record_ring_empty(RecordRing* rring) {
+	return ring_empty(&rring->ring);
+}
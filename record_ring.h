@@ -0,0 +1,122 @@
+#ifndef __UTIL_RECORD_RING_H__
+#define __UTIL_RECORD_RING_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/uio.h>
+#include "ring.h"
+
+/**
+ * @file
+ * Message framed ring buffer on top of Ring
+ *
+ * Every record is prefixed by its length and aligned to RECORD_RING_ALIGN bytes.
+ * A record never wraps around the end of the buffer, a skip marker fills the
+ * tail of the buffer instead. The skip marker is published as soon as a record
+ * does not fit in the tail, so any record up to the buffer size less its header
+ * fits once the consumer has moved past the marker. Records are published all
+ * at once, so the consumer sees either the whole record or nothing. Same single
+ * producer single consumer contract as Ring.
+ */
+
+/**
+ * Record alignment and header size
+ */
+#define RECORD_RING_ALIGN	8
+
+/**
+ * Record ring data structure
+ */
+typedef struct _RecordRing {
+	Ring		ring;		///< Underlying byte ring (internal use only)
+	size_t		reserved;	///< Bytes reserved by record_ring_reserve (internal use only)
+	size_t		pending;	///< Bytes handed out by record_ring_read_batch (internal use only)
+} RecordRing;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Create a RecordRing. record_ring_init will be called internally.
+ *
+ * @param size buffer size, it will be rounded up to power of two
+ * @param pool memory pool, if NULL local memory area will be used
+ * @return RecordRing
+ */
+RecordRing* record_ring_create(size_t size, void* pool);
+
+/**
+ * Destroy the RecordRing.
+ */
+void record_ring_destroy(RecordRing* rring);
+
+/**
+ * Initialize the RecordRing which is not created using record_ring_create function.
+ *
+ * @param rring RecordRing
+ * @param buf buffer to use, it must be aligned to RECORD_RING_ALIGN
+ * @param size buffer size, only the largest power of two not exceeding it will be used
+ */
+void record_ring_init(RecordRing* rring, char* buf, size_t size);
+
+/**
+ * Reserve space for a record to be written in place. Producer thread only.
+ *
+ * @param rring RecordRing
+ * @param len record length
+ * @return contiguous space of len bytes or NULL if the RecordRing is full,
+ *         the tail of the buffer may already be skipped in that case
+ */
+void* record_ring_reserve(RecordRing* rring, size_t len);
+
+/**
+ * Publish the record reserved by record_ring_reserve. Producer thread only.
+ *
+ * @param rring RecordRing
+ */
+void record_ring_commit(RecordRing* rring);
+
+/**
+ * Write a record. Producer thread only.
+ *
+ * @param rring RecordRing
+ * @param data record to write
+ * @param len record length
+ * @return true if the whole record is written, false if there is not enough space and nothing is written
+ */
+bool record_ring_write(RecordRing* rring, const void* data, size_t len);
+
+/**
+ * Read many records in place. Consumer thread only.
+ * The records stay valid until record_ring_release is called,
+ * calling this function again continues after the records already read.
+ *
+ * @param rring RecordRing
+ * @param records spans to be filled with the records
+ * @param count maximum number of records to read
+ * @return number of records read
+ */
+size_t record_ring_read_batch(RecordRing* rring, struct iovec* records, size_t count);
+
+/**
+ * Release every record read by record_ring_read_batch. Consumer thread only.
+ *
+ * @param rring RecordRing
+ */
+void record_ring_release(RecordRing* rring);
+
+/**
+ * Check RecordRing is empty or not
+ *
+ * @param rring RecordRing
+ * @return true if RecordRing is empty
+ */
+bool record_ring_empty(RecordRing* rring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UTIL_RECORD_RING_H__ */
@@ -1,73 +1,302 @@
+#define _GNU_SOURCE
 #include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
 #include "ring.h"
 
 ssize_t ring_write(char* buf, size_t head, volatile size_t* tail, size_t size, const char* data, size_t len) {
-	if(*tail < head) {
-		size_t len0 = head - *tail - 1;
-		if(len0 > len)
-			len0 = len;
-		
-		memcpy(buf + *tail, data, len0);
-		*tail += len0;
-
-		return len0;
-	} else {
-		size_t len1 = size - *tail;
-		size_t len2 = head;
-
-		if(len1 + len2 > len) {
-			if(len1 >= len) {
-				len1 = len;
-				len2 = 0;
-			} else
-				len2 = len - len1;
-		} else {
-			len1 = 0;
-			len2 = 0;
-		}
-		
-		memcpy(buf + *tail, data, len1);
-		memcpy(buf, data + len1, len2);
-		
-		*tail = (*tail + len1 + len2) % size;
-		return len1 + len2;
-	}
+	// Masking the free-running indices needs a power of two
+	if(size == 0 || (size & (size - 1)))
+		return -1;
+
+	// head was loaded by the caller, the space it freed must not be written before that load
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+	size_t index = *tail;
+	size_t writable = size - (index - head);
+	if(len > writable)
+		len = writable;
+
+	size_t offset = index & (size - 1);
+	size_t len1 = size - offset;
+	if(len1 > len)
+		len1 = len;
+
+	memcpy(buf + offset, data, len1);
+	memcpy(buf, data + len1, len - len1);
+
+	__atomic_store_n(tail, index + len, __ATOMIC_RELEASE);
+
+	return len;
 }
 
 ssize_t ring_read(char* buf, volatile size_t *head, size_t tail, size_t size, char* data, size_t len) {
-	if(*head <= tail) {
-		size_t len0 = tail - *head;
-		if(len0 > len)
-			len0 = len;
-		
-		memcpy(data, buf + *head, len0);
-		*head += len0;
-		
-		return len0;
-	} else {
-		size_t len1 = size - *head;
-		size_t len2 = tail;
-		
-		if(len1 >= len) {
-			len1 = len;
-			len2 = 0;
-		} else if(len1 + len2 > len) {
-			len2 = len - len1;
-		}
-		
-		memcpy(data, buf + *head, len1);
-		memcpy(data + len1, buf, len2);
-		
-		*head = (*head + len1 + len2) % size;
-		
-		return len1 + len2;
-	}
+	if(size == 0 || (size & (size - 1)))
+		return -1;
+
+	// tail was loaded by the caller, the data it covers must not be read before that load
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+	size_t index = *head;
+	size_t readable = tail - index;
+	if(len > readable)
+		len = readable;
+
+	size_t offset = index & (size - 1);
+	size_t len1 = size - offset;
+	if(len1 > len)
+		len1 = len;
+
+	memcpy(data, buf + offset, len1);
+	memcpy(data + len1, buf, len - len1);
+
+	__atomic_store_n(head, index + len, __ATOMIC_RELEASE);
+
+	return len;
 }
 
-size_t ring_readable(size_t head, size_t tail, size_t size) {
-	return head <= tail ? tail - head : size - head + tail;
+size_t ring_readable(size_t head, size_t tail) {
+	return tail - head;
 }
 
 size_t ring_writable(size_t head, size_t tail, size_t size) {
-	return tail < head ? head - tail - 1 : size - tail + head;
+	return size - (tail - head);
+}
+
+static size_t round_up(size_t size) {
+	size_t size2 = 1;
+	while(size2 < size)
+		size2 <<= 1;
+
+	return size2;
+}
+
+Ring* ring_create(size_t size, void* pool) {
+	size = round_up(size);
+
+	Ring* ring;
+	if(posix_memalign((void**)&ring, 64, sizeof(Ring)))
+		return NULL;
+
+	char* buf = malloc(size);
+	if(!buf) {
+		free(ring);
+		return NULL;
+	}
+
+	ring_init(ring, buf, size);
+	ring->pool = pool;
+
+	return ring;
+}
+
+Ring* ring_create_mirrored(size_t size, void* pool) {
+	size_t page = sysconf(_SC_PAGESIZE);
+	size = round_up(size < page ? page : size);
+
+	Ring* ring;
+	if(posix_memalign((void**)&ring, 64, sizeof(Ring)))
+		return NULL;
+
+	int fd = memfd_create("ring", MFD_CLOEXEC);
+	if(fd < 0)
+		goto error_fd;
+
+	if(ftruncate(fd, size) < 0)
+		goto error_map;
+
+	// Reserve the whole range first so that nothing else lands in between
+	char* buf = mmap(NULL, size * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if(buf == MAP_FAILED)
+		goto error_map;
+
+	if(mmap(buf, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ||
+			mmap(buf + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+		munmap(buf, size * 2);
+		goto error_map;
+	}
+
+	close(fd);
+
+	ring_init(ring, buf, size);
+	ring->span = size * 2;
+	ring->pool = pool;
+
+	return ring;
+
+error_map:
+	close(fd);
+error_fd:
+	free(ring);
+	return NULL;
+}
+
+void ring_destroy(Ring* ring) {
+	if(ring->span != ring->size)
+		munmap(ring->buf, ring->span);
+	else
+		free(ring->buf);
+	free(ring);
+}
+
+void ring_init(Ring* ring, char* buf, size_t size) {
+	// A zero length buffer is not rounded up to one byte, the Ring just holds nothing
+	size_t size2 = 1;
+	while(size2 <= size / 2)
+		size2 <<= 1;
+	size = size ? size2 : 0;
+
+	ring->head = 0;
+	ring->tail_cache = 0;
+	ring->tail = 0;
+	ring->head_cache = 0;
+	ring->buf = buf;
+	ring->size = size;
+	ring->span = size;
+	ring->pool = NULL;
+}
+
+size_t ring_write_reserve(Ring* ring, struct iovec* vec, size_t len) {
+	uint64_t tail = ring->tail;
+	size_t space = ring->size - (tail - ring->head_cache);
+	if(space < len) {
+		ring->head_cache = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+		space = ring->size - (tail - ring->head_cache);
+	}
+
+	if(len > space)
+		len = space;
+
+	// Never splits on a mirrored Ring as span - offset covers the whole buffer
+	size_t offset = tail & (ring->size - 1);
+	size_t len1 = ring->span - offset;
+	if(len1 > len)
+		len1 = len;
+
+	vec[0].iov_base = ring->buf + offset;
+	vec[0].iov_len = len1;
+	vec[1].iov_base = ring->buf;
+	vec[1].iov_len = len - len1;
+
+	return len;
+}
+
+void ring_write_commit(Ring* ring, size_t len) {
+	__atomic_store_n(&ring->tail, ring->tail + len, __ATOMIC_RELEASE);
+}
+
+size_t ring_read_peek(Ring* ring, struct iovec* vec, size_t len) {
+	uint64_t head = ring->head;
+	size_t used = ring->tail_cache - head;
+	if(used < len) {
+		ring->tail_cache = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+		used = ring->tail_cache - head;
+	}
+
+	if(len > used)
+		len = used;
+
+	size_t offset = head & (ring->size - 1);
+	size_t len1 = ring->span - offset;
+	if(len1 > len)
+		len1 = len;
+
+	vec[0].iov_base = ring->buf + offset;
+	vec[0].iov_len = len1;
+	vec[1].iov_base = ring->buf;
+	vec[1].iov_len = len - len1;
+
+	return len;
+}
+
+void ring_read_consume(Ring* ring, size_t len) {
+	__atomic_store_n(&ring->head, ring->head + len, __ATOMIC_RELEASE);
+}
+
+size_t ring_push(Ring* ring, const char* data, size_t len) {
+	struct iovec vec[2];
+	len = ring_write_reserve(ring, vec, len);
+
+	memcpy(vec[0].iov_base, data, vec[0].iov_len);
+	memcpy(vec[1].iov_base, data + vec[0].iov_len, vec[1].iov_len);
+
+	ring_write_commit(ring, len);
+
+	return len;
+}
+
+size_t ring_pop(Ring* ring, char* data, size_t len) {
+	struct iovec vec[2];
+	len = ring_read_peek(ring, vec, len);
+
+	memcpy(data, vec[0].iov_base, vec[0].iov_len);
+	memcpy(data + vec[0].iov_len, vec[1].iov_base, vec[1].iov_len);
+
+	ring_read_consume(ring, len);
+
+	return len;
+}
+
+// The Ring is user memory, not a file descriptor, so splice does not apply.
+// vmsplice to a pipe does not copy: the pipe pins the ring pages and reads them
+// later, but ring_read_consume hands the space back to the producer right away
+// and the next write would change bytes still queued in the pipe. Copying with
+// readv/writev is the only safe path without keeping the space until the pipe drains.
+ssize_t ring_fill_from_fd(Ring* ring, int fd, size_t len) {
+	struct iovec vec[2];
+	if(!ring_write_reserve(ring, vec, len))
+		return 0;
+
+	ssize_t ret = readv(fd, vec, vec[1].iov_len ? 2 : 1);
+	if(ret > 0)
+		ring_write_commit(ring, ret);
+
+	return ret;
+}
+
+ssize_t ring_drain_to_fd(Ring* ring, int fd, size_t len) {
+	struct iovec vec[2];
+	if(!ring_read_peek(ring, vec, len))
+		return 0;
+
+	ssize_t ret = writev(fd, vec, vec[1].iov_len ? 2 : 1);
+	if(ret > 0)
+		ring_read_consume(ring, ret);
+
+	return ret;
+}
+
+// A thread other than the producer and the consumer sees head and tail at
+// different times, so the difference may be out of [0, size] and is clamped
+static size_t used(Ring* ring) {
+	uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+	uint64_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+
+	if(tail < head)
+		return 0;
+	if(tail - head > ring->size)
+		return ring->size;
+
+	return tail - head;
+}
+
+size_t ring_size(Ring* ring) {
+	return used(ring);
+}
+
+size_t ring_space(Ring* ring) {
+	return ring->size - used(ring);
+}
+
+bool ring_available(Ring* ring) {
+	return ring_space(ring) > 0;
+}
+
+size_t ring_capacity(Ring* ring) {
+	return ring->size;
+}
+
+bool ring_empty(Ring* ring) {
+	return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) == __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
 }
@@ -2,62 +2,254 @@
 #define __UTIL_RING_H__
 
 #include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/uio.h>
 
 /**
  * @file
  * Ring buffer data structure for strings
  */
 
+/**
+ * Single producer single consumer ring buffer.
+ *
+ * One thread may write while another thread reads at the same time, the
+ * indices are published with release stores and observed with acquire loads.
+ * Each side keeps its own index and a cached copy of the other side's index
+ * on a separate cache line.
+ *
+ * The buffer size is a power of two and the 64-bit indices run freely without
+ * wrapping, so the whole buffer is usable and the positions are found by masking.
+ */
+typedef struct _Ring {
+	uint64_t	head __attribute__((aligned(64)));	///< Read index, written by the consumer (internal use only)
+	uint64_t	tail_cache;	///< Tail last seen by the consumer (internal use only)
+
+	uint64_t	tail __attribute__((aligned(64)));	///< Write index, written by the producer (internal use only)
+	uint64_t	head_cache;	///< Head last seen by the producer (internal use only)
+
+	char*		buf __attribute__((aligned(64)));	///< Buffer (internal use only)
+	size_t		size;		///< Buffer size, power of two (internal use only)
+	size_t		span;		///< Contiguously addressable length, size * 2 if mirrored (internal use only)
+	void*		pool;		///< Memory pool (internal use only)
+} Ring;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 /**
  * Write string to the ring buffer.
+ * head and tail are free-running byte counts which start at zero and are never
+ * wrapped by the caller, positions are found by masking them with size - 1 and
+ * the whole buffer is usable. Indices wrapped at size as in the earlier version
+ * of this function are not supported. The tail is published with a release
+ * store and an acquire fence orders the write after the caller's load of head,
+ * so a reader thread may run concurrently.
  *
  * @param buf ring buffer
- * @param head ring buffer head
- * @param tail ring buffer tail
- * @param size ring buffer size
+ * @param head ring buffer head, free-running
+ * @param tail ring buffer tail, free-running
+ * @param size ring buffer size, must be a power of two
  * @param data string to write
  * @param len string length
- * @return written length
+ * @return written length, -1 if size is not a power of two
  */
 ssize_t ring_write(char* buf, size_t head, volatile size_t* tail, size_t size, const char* data, size_t len);
 
 /**
  * Read string from the ring buffer.
+ * head and tail are free-running as in ring_write. The head is published with
+ * a release store and an acquire fence orders the read after the caller's load
+ * of tail, so a writer thread may run concurrently.
  *
  * @param buf ring buffer
- * @param head ring buffer head
- * @param tail ring buffer tail
- * @param size ring buffer size
+ * @param head ring buffer head, free-running
+ * @param tail ring buffer tail, free-running
+ * @param size ring buffer size, must be a power of two
  * @param data string bufffer to read
  * @param len string buffer length
- * @return read length
+ * @return read length, -1 if size is not a power of two
  */
 ssize_t ring_read(char* buf, volatile size_t *head, size_t tail, size_t size, char* data, size_t len);
 
 /**
- * Get written string length.
+ * Get written string length. Indices are free running, so the buffer size is not needed.
  *
  * @param head ring buffer head
  * @param tail ring buffer tail
- * @param size ring buffer size
  * @return written string length
  */
-size_t ring_readable(size_t head, size_t tail, size_t size);
+size_t ring_readable(size_t head, size_t tail);
 
 /**
  * Get available space to write.
  *
  * @param head ring buffer head
  * @param tail ring buffer tail
- * @param size ring buffer size
+ * @param size ring buffer size, power of two
  * @return available space to write
  */
 size_t ring_writable(size_t head, size_t tail, size_t size);
 
+/**
+ * Create a Ring. ring_init will be called internally.
+ *
+ * @param size buffer size, it will be rounded up to power of two
+ * @param pool memory pool, if NULL local memory area will be used
+ * @return Ring
+ */
+Ring* ring_create(size_t size, void* pool);
+
+/**
+ * Create a mirrored Ring. The buffer pages are mapped twice back to back, so
+ * every span returned by ring_write_reserve and ring_read_peek is contiguous
+ * and the second span is always empty.
+ *
+ * @param size buffer size, it will be rounded up to power of two and at least the page size
+ * @param pool memory pool, if NULL local memory area will be used
+ * @return Ring or NULL if the mapping failed
+ */
+Ring* ring_create_mirrored(size_t size, void* pool);
+
+/**
+ * Destroy the Ring.
+ */
+void ring_destroy(Ring* ring);
+
+/**
+ * Initialize the Ring which is not created using ring_create function.
+ *
+ * @param ring Ring
+ * @param buf buffer to use
+ * @param size buffer size, only the largest power of two not exceeding it will be used, zero makes a Ring which holds nothing
+ */
+void ring_init(Ring* ring, char* buf, size_t size);
+
+/**
+ * Write string to the Ring. Producer thread only.
+ *
+ * @param ring Ring
+ * @param data string to write
+ * @param len string length
+ * @return written length, may be less than len if the Ring is full
+ */
+size_t ring_push(Ring* ring, const char* data, size_t len);
+
+/**
+ * Read string from the Ring. Consumer thread only.
+ *
+ * @param ring Ring
+ * @param data string buffer to read
+ * @param len string buffer length
+ * @return read length
+ */
+size_t ring_pop(Ring* ring, char* data, size_t len);
+
+/**
+ * Reserve space to write in place. Producer thread only.
+ * The space is split into two spans when it wraps around the end of the buffer,
+ * the second span is empty otherwise. Nothing is visible to the consumer until
+ * ring_write_commit is called.
+ *
+ * @param ring Ring
+ * @param vec two spans to be filled with the reserved space
+ * @param len length to reserve
+ * @return reserved length, may be less than len if the Ring is full
+ */
+size_t ring_write_reserve(Ring* ring, struct iovec* vec, size_t len);
+
+/**
+ * Publish reserved space to the consumer. Producer thread only.
+ *
+ * @param ring Ring
+ * @param len written length, must not exceed the reserved length
+ */
+void ring_write_commit(Ring* ring, size_t len);
+
+/**
+ * Peek written string in place. Consumer thread only.
+ * The string is split into two spans when it wraps around the end of the buffer.
+ * The spans stay valid until ring_read_consume is called.
+ *
+ * @param ring Ring
+ * @param vec two spans to be filled with the written string
+ * @param len maximum length to peek
+ * @return peeked length
+ */
+size_t ring_read_peek(Ring* ring, struct iovec* vec, size_t len);
+
+/**
+ * Release peeked string to the producer. Consumer thread only.
+ *
+ * @param ring Ring
+ * @param len read length, must not exceed the peeked length
+ */
+void ring_read_consume(Ring* ring, size_t len);
+
+/**
+ * Read from a file descriptor straight into the Ring using readv. Producer thread only.
+ *
+ * @param ring Ring
+ * @param fd file descriptor to read
+ * @param len maximum length to read
+ * @return read length, zero if the Ring is full or end of file, -1 on error with errno set
+ */
+ssize_t ring_fill_from_fd(Ring* ring, int fd, size_t len);
+
+/**
+ * Write from the Ring straight to a file descriptor using writev. Consumer thread only.
+ *
+ * @param ring Ring
+ * @param fd file descriptor to write
+ * @param len maximum length to write
+ * @return written length, zero if the Ring is empty, -1 on error with errno set
+ */
+ssize_t ring_drain_to_fd(Ring* ring, int fd, size_t len);
+
+/**
+ * Get written string length. Any thread may call it while the Ring is in use,
+ * the result is a snapshot between 0 and the capacity.
+ *
+ * @param ring Ring
+ * @return written string length
+ */
+size_t ring_size(Ring* ring);
+
+/**
+ * Get available space to write. Any thread may call it while the Ring is in use,
+ * the result is a snapshot between 0 and the capacity.
+ *
+ * @param ring Ring
+ * @return available space to write
+ */
+size_t ring_space(Ring* ring);
+
+/**
+ * Check there is available space to write.
+ *
+ * @param ring Ring
+ * @return true if there is available space
+ */
+bool ring_available(Ring* ring);
+
+/**
+ * Get the maximum string length the Ring can hold, which is the buffer size.
+ *
+ * @param ring Ring
+ * @return capacity of the Ring
+ */
+size_t ring_capacity(Ring* ring);
+
+/**
+ * Check Ring is empty or not
+ *
+ * @param ring Ring
+ * @return true if Ring is empty
+ */
+bool ring_empty(Ring* ring);
+
 #ifdef __cplusplus
 }
 #endif
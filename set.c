@@ -1,6 +1,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include "set.h"
+#include "hash_batch.h"
 
 // TODO: Change accessing list using index to using iterator.
 
@@ -172,6 +173,20 @@ bool set_contains(Set* set, void* data) {
 	return false;
 }
 
+size_t set_contains_batch(Set* set, void** datas, bool* results, size_t count) {
+	size_t found = 0;
+	for(size_t base = 0; base < count; base += SET_BATCH_GROUP) {
+		size_t n = count - base < SET_BATCH_GROUP ? count - base : SET_BATCH_GROUP;
+		void* entries[SET_BATCH_GROUP];
+		found += hash_batch_lookup(set->table, set->capacity, set->hash, set->equals, datas + base, entries, n);
+
+		for(size_t i = 0; i < n; i++)
+			results[base + i] = entries[i] != NULL;
+	}
+
+	return found;
+}
+
 void* set_remove(Set* set, void* data) {
 	size_t index = set->hash(data) % set->capacity;
 	if(!set->table[index]) {
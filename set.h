@@ -9,6 +9,13 @@
  * Hash Set data structure
  */
 
+/**
+ * Number of elements set_contains_batch prefetches and looks up together
+ */
+#ifndef SET_BATCH_GROUP
+#define SET_BATCH_GROUP	16
+#endif
+
 /**
  * Hash set entry data structure (internal use only)
  */
@@ -88,6 +95,19 @@ void* set_get(Set* set, void* data);
  */
 bool set_contains(Set* set, void* data);
 
+/**
+ * Check many elements at once. Elements are processed in groups of
+ * SET_BATCH_GROUP whose buckets are prefetched before any of them is
+ * compared. See map_get_batch.
+ *
+ * @param set HashSet
+ * @param datas elements to check
+ * @param results array to store whether there is each element
+ * @param count number of elements
+ * @return number of elements found
+ */
+size_t set_contains_batch(Set* set, void** datas, bool* results, size_t count);
+
 /**
  * Remove an element from the HashSet.
  *
@@ -0,0 +1,222 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "shm_ring.h"
+
+#define MAGIC		0x676e6972206d6873UL	// "shm ring"
+#define INITIALIZING	0x74696e6900000000UL	// "init" followed by the pid of the initializer
+#define INITIALIZER(magic)	((pid_t)(uint32_t)(magic))
+
+static bool is_alive(pid_t pid) {
+	return kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+// Take the role if it is free or held by a process which does not exist anymore
+static bool claim(ShmRingHeader* header, int role) {
+	pid_t self = getpid();
+	pid_t pid = __atomic_load_n(&header->pids[role], __ATOMIC_ACQUIRE);
+	while(true) {
+		if(pid != 0 && pid != self && is_alive(pid))
+			return false;
+
+		if(__atomic_compare_exchange_n(&header->pids[role], &pid, self, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+			return true;
+	}
+}
+
+// Header page and data are mapped once, then the data is mapped again right after it
+static ShmRing* map(int fd, size_t size, int role, void* pool) {
+	size_t page = sysconf(_SC_PAGESIZE);
+	size_t length = page + size * 2;
+
+	ShmRing* ring = malloc(sizeof(ShmRing));
+	if(!ring)
+		return NULL;
+
+	char* base = mmap(NULL, length, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if(base == MAP_FAILED) {
+		free(ring);
+		return NULL;
+	}
+
+	if(mmap(base, page + size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ||
+			mmap(base + page + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, page) == MAP_FAILED) {
+		munmap(base, length);
+		free(ring);
+		return NULL;
+	}
+
+	ring->header = (ShmRingHeader*)base;
+	ring->buf = base + page;
+	ring->size = size;
+	ring->length = length;
+	ring->role = role;
+	ring->pool = pool;
+
+	return ring;
+}
+
+static void unmap(ShmRing* ring) {
+	munmap(ring->header, ring->length);
+	free(ring);
+}
+
+ShmRing* shm_ring_create(const char* name, size_t size, int role, void* pool) {
+	size_t page = sysconf(_SC_PAGESIZE);
+	size_t size2 = page;
+	while(size2 < size)
+		size2 <<= 1;
+
+	int fd = shm_open(name, O_RDWR | O_CREAT, 0600);
+	if(fd < 0)
+		return NULL;
+
+	struct stat st;
+	if(fstat(fd, &st) < 0 ||
+			(st.st_size == 0 && ftruncate(fd, page + size2) < 0) ||
+			(st.st_size != 0 && (size_t)st.st_size != page + size2)) {
+		close(fd);
+		return NULL;
+	}
+
+	ShmRing* ring = map(fd, size2, role, pool);
+	close(fd);
+	if(!ring)
+		return NULL;
+
+	// Exactly one creator initializes the header, the others wait for it. The
+	// initializer's pid is kept in magic so that a creator which died half way
+	// is taken over instead of being waited for forever.
+	ShmRingHeader* header = ring->header;
+	uint64_t initializing = INITIALIZING | (uint32_t)getpid();
+	uint64_t magic = 0;
+	while(true) {
+		if(__atomic_compare_exchange_n(&header->magic, &magic, initializing, false, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+			header->size = size2;
+			header->pids[SHM_RING_WRITER] = 0;
+			header->pids[SHM_RING_READER] = 0;
+			header->head = 0;
+			header->tail = 0;
+			__atomic_store_n(&header->magic, MAGIC, __ATOMIC_RELEASE);
+			break;
+		}
+
+		if((magic & ~0xffffffffUL) != INITIALIZING)
+			break;
+
+		// Retry with the dead initializer's magic to take over, or wait
+		if(is_alive(INITIALIZER(magic))) {
+			sched_yield();
+			magic = 0;
+		}
+	}
+
+	if(header->magic != MAGIC || header->size != size2 || !claim(header, role)) {
+		unmap(ring);
+		return NULL;
+	}
+
+	return ring;
+}
+
+ShmRing* shm_ring_attach(const char* name, int role, void* pool) {
+	size_t page = sysconf(_SC_PAGESIZE);
+
+	int fd = shm_open(name, O_RDWR, 0600);
+	if(fd < 0)
+		return NULL;
+
+	struct stat st;
+	if(fstat(fd, &st) < 0 || (size_t)st.st_size <= page) {
+		close(fd);
+		return NULL;
+	}
+
+	ShmRing* ring = map(fd, st.st_size - page, role, pool);
+	close(fd);
+	if(!ring)
+		return NULL;
+
+	ShmRingHeader* header = ring->header;
+	if(__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != MAGIC || header->size != ring->size || !claim(header, role)) {
+		unmap(ring);
+		return NULL;
+	}
+
+	return ring;
+}
+
+void shm_ring_destroy(ShmRing* ring) {
+	pid_t self = getpid();
+	__atomic_compare_exchange_n(&ring->header->pids[ring->role], &self, 0, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+	unmap(ring);
+}
+
+bool shm_ring_unlink(const char* name) {
+	return shm_unlink(name) == 0;
+}
+
+size_t shm_ring_write(ShmRing* ring, const char* data, size_t len) {
+	ShmRingHeader* header = ring->header;
+	uint64_t tail = header->tail;
+	uint64_t head = __atomic_load_n(&header->head, __ATOMIC_ACQUIRE);
+
+	size_t space = ring->size - (tail - head);
+	if(len > space)
+		len = space;
+
+	memcpy(ring->buf + (tail & (ring->size - 1)), data, len);
+	__atomic_store_n(&header->tail, tail + len, __ATOMIC_RELEASE);
+
+	return len;
+}
+
+size_t shm_ring_read(ShmRing* ring, char* data, size_t len) {
+	ShmRingHeader* header = ring->header;
+	uint64_t head = header->head;
+	uint64_t tail = __atomic_load_n(&header->tail, __ATOMIC_ACQUIRE);
+
+	size_t used = tail - head;
+	if(len > used)
+		len = used;
+
+	memcpy(data, ring->buf + (head & (ring->size - 1)), len);
+	__atomic_store_n(&header->head, head + len, __ATOMIC_RELEASE);
+
+	return len;
+}
+
+size_t shm_ring_size(ShmRing* ring) {
+	uint64_t head = __atomic_load_n(&ring->header->head, __ATOMIC_ACQUIRE);
+	uint64_t tail = __atomic_load_n(&ring->header->tail, __ATOMIC_ACQUIRE);
+
+	return tail - head;
+}
+
+size_t shm_ring_space(ShmRing* ring) {
+	return ring->size - shm_ring_size(ring);
+}
+
+bool shm_ring_available(ShmRing* ring) {
+	return shm_ring_space(ring) > 0;
+}
+
+bool shm_ring_peer_alive(ShmRing* ring) {
+	pid_t* peer = &ring->header->pids[1 - ring->role];
+	pid_t pid = __atomic_load_n(peer, __ATOMIC_ACQUIRE);
+	if(pid == 0)
+		return false;
+
+	if(is_alive(pid))
+		return true;
+
+	__atomic_compare_exchange_n(peer, &pid, 0, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+	return false;
+}
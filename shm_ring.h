@@ -0,0 +1,149 @@
+#ifndef __UTIL_SHM_RING_H__
+#define __UTIL_SHM_RING_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/types.h>
+
+/**
+ * @file
+ * Cross process ring buffer for strings in POSIX shared memory
+ *
+ * The header, the indices and the data all live in a named shared memory
+ * segment. One process writes and another process reads, each role is
+ * claimed with the process id, so a role held by a crashed process can be
+ * taken over by a new one. The data pages are mapped twice back to back,
+ * so every read and write is a single copy.
+ */
+
+/**
+ * Writer role
+ */
+#define SHM_RING_WRITER	0
+
+/**
+ * Reader role
+ */
+#define SHM_RING_READER	1
+
+/**
+ * Shared memory segment header (internal use only)
+ */
+typedef struct _ShmRingHeader {
+	uint64_t	magic;		///< Set when the segment is initialized
+	uint64_t	size;		///< Data size, power of two multiple of the page size
+	pid_t		pids[2];	///< Process ids of the writer and the reader, zero if none
+
+	uint64_t	head __attribute__((aligned(64)));	///< Read index
+	uint64_t	tail __attribute__((aligned(64)));	///< Write index
+} ShmRingHeader;
+
+/**
+ * Shared memory ring buffer data structure
+ */
+typedef struct _ShmRing {
+	ShmRingHeader*	header;		///< Shared header (internal use only)
+	char*		buf;		///< Mirrored data (internal use only)
+	size_t		size;		///< Data size (internal use only)
+	size_t		length;		///< Mapped length (internal use only)
+	int		role;		///< SHM_RING_WRITER or SHM_RING_READER (internal use only)
+	void*		pool;		///< Memory pool (internal use only)
+} ShmRing;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Create a ShmRing or open the existing one with the same size.
+ *
+ * @param name shared memory object name, e.g. "/capture"
+ * @param size data size, it will be rounded up to power of two and at least the page size
+ * @param role SHM_RING_WRITER or SHM_RING_READER
+ * @param pool memory pool, if NULL local memory area will be used
+ * @return ShmRing or NULL if the segment cannot be mapped, has other size or the role is taken by a live process
+ */
+ShmRing* shm_ring_create(const char* name, size_t size, int role, void* pool);
+
+/**
+ * Attach to an existing ShmRing.
+ *
+ * @param name shared memory object name
+ * @param role SHM_RING_WRITER or SHM_RING_READER
+ * @param pool memory pool, if NULL local memory area will be used
+ * @return ShmRing or NULL if there is no such segment or the role is taken by a live process
+ */
+ShmRing* shm_ring_attach(const char* name, int role, void* pool);
+
+/**
+ * Release the role and unmap the ShmRing. The segment itself remains.
+ */
+void shm_ring_destroy(ShmRing* ring);
+
+/**
+ * Remove the shared memory segment name. Mapped rings stay usable.
+ *
+ * @param name shared memory object name
+ * @return true if the name is removed
+ */
+bool shm_ring_unlink(const char* name);
+
+/**
+ * Write string to the ShmRing. Writer role only.
+ *
+ * @param ring ShmRing
+ * @param data string to write
+ * @param len string length
+ * @return written length, may be less than len if the ShmRing is full
+ */
+size_t shm_ring_write(ShmRing* ring, const char* data, size_t len);
+
+/**
+ * Read string from the ShmRing. Reader role only.
+ *
+ * @param ring ShmRing
+ * @param data string buffer to read
+ * @param len string buffer length
+ * @return read length
+ */
+size_t shm_ring_read(ShmRing* ring, char* data, size_t len);
+
+/**
+ * Get written string length.
+ *
+ * @param ring ShmRing
+ * @return written string length
+ */
+size_t shm_ring_size(ShmRing* ring);
+
+/**
+ * Get available space to write.
+ *
+ * @param ring ShmRing
+ * @return available space to write
+ */
+size_t shm_ring_space(ShmRing* ring);
+
+/**
+ * Check there is available space to write.
+ *
+ * @param ring ShmRing
+ * @return true if there is available space
+ */
+bool shm_ring_available(ShmRing* ring);
+
+/**
+ * Check the process of the other role is alive.
+ * If it is not, its role is released so that a new process can attach.
+ *
+ * @param ring ShmRing
+ * @return true if the other role is held by a live process
+ */
+bool shm_ring_peer_alive(ShmRing* ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UTIL_SHM_RING_H__ */
@@ -0,0 +1,183 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include "slotmap.h"
+
+#define NONE			UINT32_MAX
+
+#define HANDLE(slot, gen)	(((uint64_t)(gen) << 32) | (slot))
+#define HANDLE_SLOT(handle)	((uint32_t)(handle))
+#define HANDLE_GEN(handle)	((uint32_t)((handle) >> 32))
+
+static SlotMapSlot* lookup(SlotMap* slotmap, uint64_t handle) {
+	uint32_t slot = HANDLE_SLOT(handle);
+	if(slot >= slotmap->slot_count)
+		return NULL;
+
+	SlotMapSlot* s = &slotmap->slots[slot];
+	if(s->generation != HANDLE_GEN(handle) || !(s->generation & 1))
+		return NULL;
+
+	return s;
+}
+
+static void* remove_dense(SlotMap* slotmap, uint32_t slot) {
+	SlotMapSlot* s = &slotmap->slots[slot];
+	uint32_t index = s->index;
+
+	// The last dense element moves into the hole
+	void* data = vector_swap_remove(slotmap->values, index);
+	vector_swap_remove(slotmap->owners, index);
+	if(index < vector_size(slotmap->owners))
+		slotmap->slots[(uintptr_t)vector_get(slotmap->owners, index)].index = index;
+
+	s->generation++;
+	s->index = slotmap->free;
+	slotmap->free = slot;
+
+	return data;
+}
+
+SlotMap* slotmap_create(size_t size, void* pool) {
+	SlotMap* slotmap = malloc(sizeof(SlotMap));
+	if(!slotmap)
+		return NULL;
+
+	if(size == 0)
+		size = 1;
+
+	slotmap->values = vector_create(size, pool);
+	slotmap->owners = vector_create(size, pool);
+	slotmap->slots = malloc(sizeof(SlotMapSlot) * size);
+	if(!slotmap->values || !slotmap->owners || !slotmap->slots) {
+		if(slotmap->values)
+			vector_destroy(slotmap->values);
+		if(slotmap->owners)
+			vector_destroy(slotmap->owners);
+		free(slotmap->slots);
+		free(slotmap);
+		return NULL;
+	}
+
+	slotmap->slot_count = 0;
+	slotmap->slot_size = size;
+	slotmap->free = NONE;
+	slotmap->pool = pool;
+
+	return slotmap;
+}
+
+void slotmap_destroy(SlotMap* slotmap) {
+	vector_destroy(slotmap->values);
+	vector_destroy(slotmap->owners);
+	free(slotmap->slots);
+	free(slotmap);
+}
+
+bool slotmap_is_empty(SlotMap* slotmap) {
+	return vector_is_empty(slotmap->values);
+}
+
+uint64_t slotmap_insert(SlotMap* slotmap, void* data) {
+	uint32_t slot = slotmap->free;
+	if(slot == NONE) {
+		if(slotmap->slot_count >= NONE)
+			return 0;
+
+		if(slotmap->slot_count >= slotmap->slot_size) {
+			size_t size = vector_growth_default(slotmap->slot_size, slotmap->slot_count + 1);
+			SlotMapSlot* slots = realloc(slotmap->slots, sizeof(SlotMapSlot) * size);
+			if(!slots)
+				return 0;
+
+			slotmap->slots = slots;
+			slotmap->slot_size = size;
+		}
+
+		slot = slotmap->slot_count;
+		slotmap->slots[slot].generation = 0;
+		slotmap->slots[slot].index = NONE;
+	}
+
+	size_t index = vector_size(slotmap->values);
+	if(!vector_add(slotmap->values, data))
+		return 0;
+
+	if(!vector_add(slotmap->owners, (void*)(uintptr_t)slot)) {
+		vector_remove_last(slotmap->values);
+		return 0;
+	}
+
+	if(slot == slotmap->free)
+		slotmap->free = slotmap->slots[slot].index;
+	else
+		slotmap->slot_count++;
+
+	SlotMapSlot* s = &slotmap->slots[slot];
+	s->index = index;
+	s->generation++;
+
+	return HANDLE(slot, s->generation);
+}
+
+void* slotmap_get(SlotMap* slotmap, uint64_t handle) {
+	SlotMapSlot* s = lookup(slotmap, handle);
+	if(!s)
+		return NULL;
+
+	return vector_get(slotmap->values, s->index);
+}
+
+bool slotmap_update(SlotMap* slotmap, uint64_t handle, void* data) {
+	SlotMapSlot* s = lookup(slotmap, handle);
+	if(!s)
+		return false;
+
+	slotmap->values->array[s->index] = data;
+	return true;
+}
+
+bool slotmap_contains(SlotMap* slotmap, uint64_t handle) {
+	return lookup(slotmap, handle) != NULL;
+}
+
+void* slotmap_remove(SlotMap* slotmap, uint64_t handle) {
+	if(!lookup(slotmap, handle))
+		return NULL;
+
+	return remove_dense(slotmap, HANDLE_SLOT(handle));
+}
+
+size_t slotmap_size(SlotMap* slotmap) {
+	return vector_size(slotmap->values);
+}
+
+void slotmap_iterator_init(SlotMapIterator* iter, SlotMap* slotmap) {
+	iter->slotmap = slotmap;
+	iter->index = 0;
+}
+
+bool slotmap_iterator_has_next(SlotMapIterator* iter) {
+	return iter->index < vector_size(iter->slotmap->values);
+}
+
+void* slotmap_iterator_next(SlotMapIterator* iter, uint64_t* handle) {
+	if(iter->index >= vector_size(iter->slotmap->values))
+		return NULL;
+
+	if(handle) {
+		uint32_t slot = (uintptr_t)vector_get(iter->slotmap->owners, iter->index);
+		*handle = HANDLE(slot, iter->slotmap->slots[slot].generation);
+	}
+
+	return vector_get(iter->slotmap->values, iter->index++);
+}
+
+void* slotmap_iterator_remove(SlotMapIterator* iter) {
+	if(iter->index == 0)
+		return NULL;
+
+	// The last element moves into the removed position, so visit it next
+	iter->index--;
+	uint32_t slot = (uintptr_t)vector_get(iter->slotmap->owners, iter->index);
+	return remove_dense(iter->slotmap, slot);
+}
@@ -0,0 +1,166 @@
+#ifndef __UTIL_SLOTMAP_H__
+#define __UTIL_SLOTMAP_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "vector.h"
+
+/**
+ * @file
+ * Slot Map data structure (generational index)
+ *
+ * Elements are referred to by handles which stay valid until the element is
+ * removed, no matter how many other elements are added or removed. A handle
+ * of a removed element never matches a later element in the same slot.
+ * Live elements are kept dense in a Vector for fast iteration.
+ */
+
+/**
+ * Slot Map slot (internal use only)
+ */
+typedef struct _SlotMapSlot {
+	uint32_t	index;		///< Dense index if live, next free slot otherwise
+	uint32_t	generation;	///< Odd if live, even if free
+} SlotMapSlot;
+
+/**
+ * Slot Map data structure
+ */
+typedef struct _SlotMap {
+	Vector*		values;		///< Dense live elements (internal use only)
+	Vector*		owners;		///< Slot of each dense element (internal use only)
+	SlotMapSlot*	slots;		///< Slots (internal use only)
+	size_t		slot_count;	///< Number of used slots (internal use only)
+	size_t		slot_size;	///< Slots array size (internal use only)
+	uint32_t	free;		///< First free slot (internal use only)
+	void*		pool;		///< Memory pool (internal use only)
+} SlotMap;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Create a SlotMap.
+ *
+ * @param size initial number of elements to allocate
+ * @param pool memory pool to use, if NULL local memory area will be used
+ */
+SlotMap* slotmap_create(size_t size, void* pool);
+
+/**
+ * Destroy the SlotMap.
+ *
+ * @param slotmap SlotMap
+ */
+void slotmap_destroy(SlotMap* slotmap);
+
+/**
+ * Check the SlotMap is empty or not.
+ *
+ * @param slotmap SlotMap
+ * @return true if the SlotMap is empty
+ */
+bool slotmap_is_empty(SlotMap* slotmap);
+
+/**
+ * Insert an element to the SlotMap.
+ *
+ * @param slotmap SlotMap
+ * @param data an element to insert
+ * @return handle of the element or 0 if there is no more memory to allocate
+ */
+uint64_t slotmap_insert(SlotMap* slotmap, void* data);
+
+/**
+ * Get an element from the SlotMap.
+ *
+ * @param slotmap SlotMap
+ * @param handle handle of the element
+ * @return the element or NULL if the handle is not valid
+ */
+void* slotmap_get(SlotMap* slotmap, uint64_t handle);
+
+/**
+ * Replace an element of the SlotMap.
+ *
+ * @param slotmap SlotMap
+ * @param handle handle of the element
+ * @param data the new element
+ * @return true if the element is updated, false if the handle is not valid
+ */
+bool slotmap_update(SlotMap* slotmap, uint64_t handle, void* data);
+
+/**
+ * Check the handle refers to a live element.
+ *
+ * @param slotmap SlotMap
+ * @param handle handle of the element
+ * @return true if the handle is valid
+ */
+bool slotmap_contains(SlotMap* slotmap, uint64_t handle);
+
+/**
+ * Remove an element from the SlotMap.
+ *
+ * @param slotmap SlotMap
+ * @param handle handle of the element
+ * @return removed element or NULL if the handle is not valid
+ */
+void* slotmap_remove(SlotMap* slotmap, uint64_t handle);
+
+/**
+ * Get the number of elements of the SlotMap.
+ *
+ * @param slotmap SlotMap
+ * @return number of elements
+ */
+size_t slotmap_size(SlotMap* slotmap);
+
+/**
+ * Iterator of a SlotMap. Elements are visited in dense order, not in insertion order.
+ */
+typedef struct _SlotMapIterator {
+	SlotMap*	slotmap;	///< SlotMap (internal use only)
+	size_t		index;		///< current dense position (internal use only)
+} SlotMapIterator;
+
+/**
+ * Initialize the iterator.
+ *
+ * @param iter the iterator
+ * @param slotmap SlotMap
+ */
+void slotmap_iterator_init(SlotMapIterator* iter, SlotMap* slotmap);
+
+/**
+ * Check there is more element to iterate.
+ *
+ * @param iter iterator
+ * @return true if there is more element to iterate
+ */
+bool slotmap_iterator_has_next(SlotMapIterator* iter);
+
+/**
+ * Get next element from iterator.
+ *
+ * @param iter iterator
+ * @param handle if not NULL, handle of the element is stored
+ * @return next element
+ */
+void* slotmap_iterator_next(SlotMapIterator* iter, uint64_t* handle);
+
+/**
+ * Remove the element from the SlotMap which is recently iterated using slotmap_iterator_next function.
+ *
+ * @param iter iterator
+ * @return removed element
+ */
+void* slotmap_iterator_remove(SlotMapIterator* iter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UTIL_SLOTMAP_H__ */
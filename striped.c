@@ -0,0 +1,71 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include "striped.h"
+
+#define GOLDEN_RATIO	0x9e3779b97f4a7c15UL
+
+bool stripes_init(Stripes* stripes, size_t initial_capacity, size_t segments, void*(*create)(size_t capacity, void* context), void(*destroy)(void* table), void* context) {
+	size_t count = 1;
+	int shift = 64;
+	while(count < segments) {
+		count <<= 1;
+		shift--;
+	}
+
+	if(posix_memalign((void**)&stripes->segments, 64, sizeof(Stripe) * count) != 0)
+		return false;
+
+	size_t capacity = (initial_capacity + count - 1) / count;
+	for(size_t i = 0; i < count; i++) {
+		stripes->segments[i].table = create(capacity, context);
+		if(!stripes->segments[i].table) {
+			while(i-- > 0) {
+				destroy(stripes->segments[i].table);
+				pthread_mutex_destroy(&stripes->segments[i].lock);
+			}
+			free(stripes->segments);
+			return false;
+		}
+		pthread_mutex_init(&stripes->segments[i].lock, NULL);
+	}
+
+	stripes->count = count;
+	stripes->shift = shift;
+
+	return true;
+}
+
+void stripes_fini(Stripes* stripes, void(*destroy)(void* table)) {
+	for(size_t i = 0; i < stripes->count; i++) {
+		destroy(stripes->segments[i].table);
+		pthread_mutex_destroy(&stripes->segments[i].lock);
+	}
+
+	free(stripes->segments);
+}
+
+// The table picks a bucket from the low bits, so the segment comes from the high bits of a mixed hash
+Stripe* stripes_lock(Stripes* stripes, uint64_t(*hash)(void*), void* key) {
+	Stripe* stripe = stripes->segments;
+	if(stripes->count > 1)
+		stripe += (hash(key) * GOLDEN_RATIO) >> stripes->shift;
+
+	pthread_mutex_lock(&stripe->lock);
+	return stripe;
+}
+
+void stripes_unlock(Stripe* stripe) {
+	pthread_mutex_unlock(&stripe->lock);
+}
+
+size_t stripes_size(Stripes* stripes, size_t(*size)(void* table)) {
+	size_t total = 0;
+	for(size_t i = 0; i < stripes->count; i++) {
+		Stripe* stripe = &stripes->segments[i];
+		pthread_mutex_lock(&stripe->lock);
+		total += size(stripe->table);
+		pthread_mutex_unlock(&stripe->lock);
+	}
+
+	return total;
+}
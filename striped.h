@@ -0,0 +1,90 @@
+#ifndef __UTIL_STRIPED_H__
+#define __UTIL_STRIPED_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+/**
+ * @file
+ * Lock striping shared by StripedMap and StripedSet (internal use only)
+ *
+ * Each segment pairs a lock with its own table, a Map or a Set, and is padded
+ * to its own cache line. The segment of a key comes from the high bits of its
+ * mixed hash, as the table picks a bucket from the low bits.
+ */
+
+/**
+ * Lock striped segment (internal use only)
+ */
+typedef struct _Stripe {
+	pthread_mutex_t	lock;		///< Segment lock
+	void*		table;		///< Elements of the segment, a Map or a Set
+} __attribute__((aligned(64))) Stripe;
+
+/**
+ * Lock striped segments (internal use only)
+ */
+typedef struct _Stripes {
+	Stripe*		segments;	///< Segments
+	size_t		count;		///< Number of segments, power of two
+	int		shift;		///< Shift to pick a segment from the mixed hash
+} Stripes;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initialize the segments, each with its own table.
+ *
+ * @param stripes Stripes
+ * @param initial_capacity respected maximum number of elements of all segments
+ * @param segments number of segments which is rounded up to a power of two
+ * @param create function creating a table of a capacity
+ * @param destroy function destroying a table
+ * @param context context to pass to create
+ * @return false if there is no more memory to allocate
+ */
+bool stripes_init(Stripes* stripes, size_t initial_capacity, size_t segments, void*(*create)(size_t capacity, void* context), void(*destroy)(void* table), void* context);
+
+/**
+ * Destroy the tables and the segments. No thread may access them anymore.
+ *
+ * @param stripes Stripes
+ * @param destroy function destroying a table
+ */
+void stripes_fini(Stripes* stripes, void(*destroy)(void* table));
+
+/**
+ * Lock the segment of the key.
+ *
+ * @param stripes Stripes
+ * @param hash key hashing function
+ * @param key key
+ * @return locked segment, to be unlocked with stripes_unlock
+ */
+Stripe* stripes_lock(Stripes* stripes, uint64_t(*hash)(void*), void* key);
+
+/**
+ * Unlock the segment locked by stripes_lock.
+ *
+ * @param stripe segment
+ */
+void stripes_unlock(Stripe* stripe);
+
+/**
+ * Sum the sizes of the tables, locking the segments one by one.
+ *
+ * @param stripes Stripes
+ * @param size function returning the number of elements of a table
+ * @return number of elements
+ */
+size_t stripes_size(Stripes* stripes, size_t(*size)(void* table));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UTIL_STRIPED_H__ */
@@ -0,0 +1,95 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include "striped_map.h"
+
+static void* create(size_t capacity, void* context) {
+	StripedMap* map = context;
+	return map_create(capacity, map->hash, map->equals, map->pool);
+}
+
+static void destroy(void* table) {
+	map_destroy(table);
+}
+
+static size_t size(void* table) {
+	return map_size(table);
+}
+
+StripedMap* striped_map_create(size_t initial_capacity, size_t segments, uint64_t(*hash)(void*), bool(*equals)(void*,void*), void* pool) {
+	if(!equals)
+		equals = map_uint64_equals;
+
+	if(!hash)
+		hash = map_uint64_hash;
+
+	if(segments == 0)
+		segments = STRIPED_MAP_SEGMENTS;
+
+	StripedMap* map = malloc(sizeof(StripedMap));
+	if(!map)
+		return NULL;
+
+	map->hash = hash;
+	map->equals = equals;
+	map->pool = pool;
+
+	if(!stripes_init(&map->stripes, initial_capacity, segments, create, destroy, map)) {
+		free(map);
+		return NULL;
+	}
+
+	return map;
+}
+
+void striped_map_destroy(StripedMap* map) {
+	stripes_fini(&map->stripes, destroy);
+	free(map);
+}
+
+bool striped_map_is_empty(StripedMap* map) {
+	return striped_map_size(map) == 0;
+}
+
+bool striped_map_put(StripedMap* map, void* key, void* data) {
+	Stripe* stripe = stripes_lock(&map->stripes, map->hash, key);
+	bool result = map_put(stripe->table, key, data);
+	stripes_unlock(stripe);
+
+	return result;
+}
+
+bool striped_map_update(StripedMap* map, void* key, void* data) {
+	Stripe* stripe = stripes_lock(&map->stripes, map->hash, key);
+	bool result = map_update(stripe->table, key, data);
+	stripes_unlock(stripe);
+
+	return result;
+}
+
+void* striped_map_get(StripedMap* map, void* key) {
+	Stripe* stripe = stripes_lock(&map->stripes, map->hash, key);
+	void* data = map_get(stripe->table, key);
+	stripes_unlock(stripe);
+
+	return data;
+}
+
+bool striped_map_contains(StripedMap* map, void* key) {
+	Stripe* stripe = stripes_lock(&map->stripes, map->hash, key);
+	bool result = map_contains(stripe->table, key);
+	stripes_unlock(stripe);
+
+	return result;
+}
+
+void* striped_map_remove(StripedMap* map, void* key) {
+	Stripe* stripe = stripes_lock(&map->stripes, map->hash, key);
+	void* data = map_remove(stripe->table, key);
+	stripes_unlock(stripe);
+
+	return data;
+}
+
+size_t striped_map_size(StripedMap* map) {
+	return stripes_size(&map->stripes, size);
+}
@@ -0,0 +1,128 @@
+#ifndef __UTIL_STRIPED_MAP_H__
+#define __UTIL_STRIPED_MAP_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "map.h"
+#include "striped.h"
+
+/**
+ * @file
+ * Concurrent Hash Map data structure (lock striping)
+ *
+ * Elements are spread over segments, each of which is a Map guarded by its
+ * own lock, so threads working on different segments do not contend. Each
+ * segment grows on its own without stopping the others.
+ */
+
+/**
+ * Default number of segments
+ */
+#ifndef STRIPED_MAP_SEGMENTS
+#define STRIPED_MAP_SEGMENTS	16
+#endif
+
+/**
+ * Concurrent Hash Map data structure
+ */
+typedef struct _StripedMap {
+	Stripes		stripes;	///< Segments (internal use only)
+
+	uint64_t(*hash)(void*);		///< hashing function
+	bool(*equals)(void*,void*);	///< comparing function
+
+	void*		pool;		///< Memory pool (internal use only)
+} StripedMap;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Create a striped HashMap.
+ *
+ * @param initial_capacity respected maximum number of elements
+ * @param segments number of segments which is rounded up to a power of two, if 0 STRIPED_MAP_SEGMENTS will be used
+ * @param hash key hashing function, if hash is NULL map_uint64_hash will be used
+ * @param equals key comparing function, if equals is NULL map_uint64_equals will be used
+ * @param pool memory pool to use, if NULL local memory area will be used
+ */
+StripedMap* striped_map_create(size_t initial_capacity, size_t segments, uint64_t(*hash)(void*), bool(*equals)(void*,void*), void* pool);
+
+/**
+ * Destroy the striped HashMap. No thread may access it anymore.
+ *
+ * @param map striped HashMap
+ */
+void striped_map_destroy(StripedMap* map);
+
+/**
+ * Check the striped HashMap is empty or not.
+ *
+ * @param map striped HashMap
+ * @return true if the striped HashMap is empty
+ */
+bool striped_map_is_empty(StripedMap* map);
+
+/**
+ * Put an element to the striped HashMap.
+ *
+ * @param map striped HashMap
+ * @param key key of element
+ * @param data data of element
+ * @return true if the element is putted, false if there is an element with same key or memory is full
+ */
+bool striped_map_put(StripedMap* map, void* key, void* data);
+
+/**
+ * Update an element with new key and data.
+ *
+ * @param map striped HashMap
+ * @param key new key of the element
+ * @param data new data of the element
+ * @return true if the element is updated, false if there is no such element
+ */
+bool striped_map_update(StripedMap* map, void* key, void* data);
+
+/**
+ * Get an element data from the striped HashMap.
+ *
+ * @param map striped HashMap
+ * @param key key of the element
+ * @return the element's data or NULL if there is no such element
+ */
+void* striped_map_get(StripedMap* map, void* key);
+
+/**
+ * Check there is an element.
+ *
+ * @param map striped HashMap
+ * @param key key of the element
+ * @return true if there is an element with the key
+ */
+bool striped_map_contains(StripedMap* map, void* key);
+
+/**
+ * Remove an element from the striped HashMap.
+ *
+ * @param map striped HashMap
+ * @param key key of the element
+ * @return removed element or NULL if nothing is removed
+ */
+void* striped_map_remove(StripedMap* map, void* key);
+
+/**
+ * Get the number of elements of the striped HashMap. The segments are
+ * counted one by one, so it is not exact while other threads modify it.
+ *
+ * @param map striped HashMap
+ * @return number of elements
+ */
+size_t striped_map_size(StripedMap* map);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UTIL_STRIPED_MAP_H__ */
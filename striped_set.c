@@ -0,0 +1,87 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include "striped_set.h"
+
+static void* create(size_t capacity, void* context) {
+	StripedSet* set = context;
+	return set_create(capacity, set->hash, set->equals, set->pool);
+}
+
+static void destroy(void* table) {
+	set_destroy(table);
+}
+
+static size_t size(void* table) {
+	return set_size(table);
+}
+
+StripedSet* striped_set_create(size_t initial_capacity, size_t segments, uint64_t(*hash)(void*), bool(*equals)(void*,void*), void* pool) {
+	if(!equals)
+		equals = set_uint64_equals;
+
+	if(!hash)
+		hash = set_uint64_hash;
+
+	if(segments == 0)
+		segments = STRIPED_SET_SEGMENTS;
+
+	StripedSet* set = malloc(sizeof(StripedSet));
+	if(!set)
+		return NULL;
+
+	set->hash = hash;
+	set->equals = equals;
+	set->pool = pool;
+
+	if(!stripes_init(&set->stripes, initial_capacity, segments, create, destroy, set)) {
+		free(set);
+		return NULL;
+	}
+
+	return set;
+}
+
+void striped_set_destroy(StripedSet* set) {
+	stripes_fini(&set->stripes, destroy);
+	free(set);
+}
+
+bool striped_set_is_empty(StripedSet* set) {
+	return striped_set_size(set) == 0;
+}
+
+bool striped_set_put(StripedSet* set, void* data) {
+	Stripe* stripe = stripes_lock(&set->stripes, set->hash, data);
+	bool result = set_put(stripe->table, data);
+	stripes_unlock(stripe);
+
+	return result;
+}
+
+void* striped_set_get(StripedSet* set, void* data) {
+	Stripe* stripe = stripes_lock(&set->stripes, set->hash, data);
+	void* result = set_get(stripe->table, data);
+	stripes_unlock(stripe);
+
+	return result;
+}
+
+bool striped_set_contains(StripedSet* set, void* data) {
+	Stripe* stripe = stripes_lock(&set->stripes, set->hash, data);
+	bool result = set_contains(stripe->table, data);
+	stripes_unlock(stripe);
+
+	return result;
+}
+
+void* striped_set_remove(StripedSet* set, void* data) {
+	Stripe* stripe = stripes_lock(&set->stripes, set->hash, data);
+	void* result = set_remove(stripe->table, data);
+	stripes_unlock(stripe);
+
+	return result;
+}
+
+size_t striped_set_size(StripedSet* set) {
+	return stripes_size(&set->stripes, size);
+}
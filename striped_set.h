@@ -0,0 +1,117 @@
+#ifndef __UTIL_STRIPED_SET_H__
+#define __UTIL_STRIPED_SET_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "set.h"
+#include "striped.h"
+
+/**
+ * @file
+ * Concurrent Hash Set data structure (lock striping)
+ *
+ * Elements are spread over segments, each of which is a Set guarded by its
+ * own lock, so threads working on different segments do not contend. Each
+ * segment grows on its own without stopping the others.
+ */
+
+/**
+ * Default number of segments
+ */
+#ifndef STRIPED_SET_SEGMENTS
+#define STRIPED_SET_SEGMENTS	16
+#endif
+
+/**
+ * Concurrent Hash Set data structure
+ */
+typedef struct _StripedSet {
+	Stripes		stripes;	///< Segments (internal use only)
+
+	uint64_t(*hash)(void*);		///< hashing function
+	bool(*equals)(void*,void*);	///< comparing function
+
+	void*		pool;		///< Memory pool (internal use only)
+} StripedSet;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Create a striped HashSet.
+ *
+ * @param initial_capacity respected maximum number of elements
+ * @param segments number of segments which is rounded up to a power of two, if 0 STRIPED_SET_SEGMENTS will be used
+ * @param hash data hashing function, if hash is NULL set_uint64_hash will be used
+ * @param equals data comparing function, if equals is NULL set_uint64_equals will be used
+ * @param pool memory pool to use, if NULL local memory area will be used
+ */
+StripedSet* striped_set_create(size_t initial_capacity, size_t segments, uint64_t(*hash)(void*), bool(*equals)(void*,void*), void* pool);
+
+/**
+ * Destroy the striped HashSet. No thread may access it anymore.
+ *
+ * @param set striped HashSet
+ */
+void striped_set_destroy(StripedSet* set);
+
+/**
+ * Check the striped HashSet is empty or not.
+ *
+ * @param set striped HashSet
+ * @return true if the striped HashSet is empty
+ */
+bool striped_set_is_empty(StripedSet* set);
+
+/**
+ * Put an element to the striped HashSet.
+ *
+ * @param set striped HashSet
+ * @param data element
+ * @return true if the element is putted, false if there is an element with same data or memory is full
+ */
+bool striped_set_put(StripedSet* set, void* data);
+
+/**
+ * Get an element data from the striped HashSet.
+ *
+ * @param set striped HashSet
+ * @param data the element
+ * @return the element's data or NULL if there is no such element
+ */
+void* striped_set_get(StripedSet* set, void* data);
+
+/**
+ * Check there is an element.
+ *
+ * @param set striped HashSet
+ * @param data the element
+ * @return true if there is an element with the data
+ */
+bool striped_set_contains(StripedSet* set, void* data);
+
+/**
+ * Remove an element from the striped HashSet.
+ *
+ * @param set striped HashSet
+ * @param data the element
+ * @return removed element or NULL if nothing is removed
+ */
+void* striped_set_remove(StripedSet* set, void* data);
+
+/**
+ * Get the number of elements of the striped HashSet. The segments are
+ * counted one by one, so it is not exact while other threads modify it.
+ *
+ * @param set striped HashSet
+ * @return number of elements
+ */
+size_t striped_set_size(StripedSet* set);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UTIL_STRIPED_SET_H__ */
@@ -0,0 +1,113 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include <assert.h>
+#include "bfifo.h"
+
+#define PRODUCERS	3
+#define CONSUMERS	2
+#define COUNT		20000
+#define STOP		((void*)UINTPTR_MAX)
+
+static BlockingFIFO* bfifo;
+static uint32_t seen[PRODUCERS * COUNT + 1];
+
+static void* produce(void* arg) {
+	uintptr_t base = (uintptr_t)arg * COUNT;
+	for(uintptr_t i = 1; i <= COUNT; i++)
+		assert(bfifo_push_wait(bfifo, (void*)(base + i), -1));
+
+	return NULL;
+}
+
+static void* consume(void* arg) {
+	while(true) {
+		void* data = bfifo_pop_wait(bfifo, -1);
+		assert(data);
+		if(data == STOP)
+			return NULL;
+
+		__atomic_fetch_add(&seen[(uintptr_t)data], 1, __ATOMIC_RELAXED);
+	}
+}
+
+// Every pushed element is popped exactly once through a small FIFO, so both directions wait
+static void handoff() {
+	bfifo = bfifo_create(8, NULL);
+	assert(bfifo);
+
+	pthread_t producers[PRODUCERS];
+	pthread_t consumers[CONSUMERS];
+	for(uintptr_t i = 0; i < CONSUMERS; i++)
+		pthread_create(&consumers[i], NULL, consume, NULL);
+	for(uintptr_t i = 0; i < PRODUCERS; i++)
+		pthread_create(&producers[i], NULL, produce, (void*)i);
+
+	for(int i = 0; i < PRODUCERS; i++)
+		pthread_join(producers[i], NULL);
+	for(int i = 0; i < CONSUMERS; i++)
+		assert(bfifo_push_wait(bfifo, STOP, -1));
+	for(int i = 0; i < CONSUMERS; i++)
+		pthread_join(consumers[i], NULL);
+
+	for(int i = 1; i <= PRODUCERS * COUNT; i++)
+		assert(seen[i] == 1);
+	assert(bfifo_empty(bfifo));
+
+	bfifo_destroy(bfifo);
+}
+
+// Waits give up after the timeout, zero timeout does not wait
+static void timeout() {
+	bfifo = bfifo_create(2, NULL);
+	assert(bfifo);
+
+	struct timespec start, end;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	assert(!bfifo_pop_wait(bfifo, 20000000));
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	assert((end.tv_sec - start.tv_sec) * 1000000000L + end.tv_nsec - start.tv_nsec >= 20000000);
+	assert(!bfifo_pop_wait(bfifo, 0));
+
+	uintptr_t count = 0;
+	while(bfifo_push_wait(bfifo, (void*)(count + 1), 0))
+		count++;
+	assert(count > 0);
+	assert(!bfifo_push_wait(bfifo, (void*)1, 20000000));
+	for(uintptr_t i = 1; i <= count; i++)
+		assert(bfifo_pop_wait(bfifo, 0) == (void*)i);
+
+	bfifo_destroy(bfifo);
+}
+
+static void* push_later(void* arg) {
+	struct timespec ts = { 0, 10000000 };
+	nanosleep(&ts, NULL);
+	assert(bfifo_push(bfifo, arg));
+
+	return NULL;
+}
+
+// A parked consumer is woken by a later push
+static void wakeup() {
+	bfifo = bfifo_create(4, NULL);
+	assert(bfifo);
+	bfifo_set_spin(bfifo, 0);
+
+	pthread_t thread;
+	pthread_create(&thread, NULL, push_later, (void*)42);
+	assert(bfifo_pop_wait(bfifo, -1) == (void*)42);
+	pthread_join(thread, NULL);
+
+	bfifo_destroy(bfifo);
+}
+
+int main(int argc, char** argv) {
+	handoff();
+	timeout();
+	wakeup();
+
+	printf("bfifo_test: ok\n");
+	return 0;
+}
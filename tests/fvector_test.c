@@ -0,0 +1,129 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <assert.h>
+#include "fvector.h"
+
+// Adding an element of the vector itself while the mapping moves
+static void add_own_element() {
+	char path[] = "/tmp/fvector_test.XXXXXX";
+	int fd = mkstemp(path);
+	assert(fd >= 0);
+	close(fd);
+	unlink(path);
+
+	FileVector* fvector = fvector_open(path, sizeof(uint64_t), 4, NULL);
+	assert(fvector);
+
+	for(uint64_t i = 0; i < fvector_capacity(fvector); i++)
+		assert(fvector_add(fvector, &i));
+
+	for(int i = 0; i < 100000; i++)
+		assert(fvector_add(fvector, fvector_get(fvector, 0)));
+
+	size_t count = fvector_size(fvector);
+	for(size_t i = count - 100000; i < count; i++)
+		assert(*(uint64_t*)fvector_get(fvector, i) == 0);
+
+	fvector_close(fvector);
+	unlink(path);
+}
+
+// Header count stored in the file, read without mapping it
+static uint64_t file_count(const char* path) {
+	FileVectorHeader header;
+	int fd = open(path, O_RDONLY);
+	assert(fd >= 0);
+	assert(pread(fd, &header, sizeof(header), 0) == sizeof(header));
+	close(fd);
+
+	return header.count;
+}
+
+// Elements survive close and reopen, the header count only moves on checkpoint and close
+static void reopen() {
+	char path[] = "/tmp/fvector_test.XXXXXX";
+	int fd = mkstemp(path);
+	assert(fd >= 0);
+	close(fd);
+	unlink(path);
+
+	FileVector* fvector = fvector_open(path, sizeof(uint64_t), 4, NULL);
+	assert(fvector);
+	for(uint64_t i = 0; i < 1000; i++)
+		assert(fvector_add(fvector, &i));
+	assert(file_count(path) == 0);
+
+	assert(fvector_checkpoint(fvector, true));
+	assert(file_count(path) == 1000);
+
+	for(uint64_t i = 1000; i < 1500; i++)
+		assert(fvector_add(fvector, &i));
+	assert(fvector_remove_last(fvector, NULL));
+	assert(file_count(path) == 1000);
+	fvector_close(fvector);
+	assert(file_count(path) == 1499);
+
+	fvector = fvector_open(path, sizeof(uint64_t), 4, NULL);
+	assert(fvector);
+	assert(fvector_size(fvector) == 1499);
+	assert(fvector_capacity(fvector) >= 1499);
+	for(uint64_t i = 0; i < 1499; i++)
+		assert(*(uint64_t*)fvector_get(fvector, i) == i);
+	assert(!fvector_get(fvector, 1499));
+	fvector_close(fvector);
+
+	unlink(path);
+}
+
+// A file of other element size, version or magic is not opened
+static void reject_mismatch() {
+	char path[] = "/tmp/fvector_test.XXXXXX";
+	int fd = mkstemp(path);
+	assert(fd >= 0);
+	close(fd);
+	unlink(path);
+
+	FileVector* fvector = fvector_open(path, sizeof(uint64_t), 4, NULL);
+	assert(fvector);
+	fvector_close(fvector);
+
+	assert(!fvector_open(path, sizeof(uint32_t), 4, NULL));
+	assert(!fvector_open(path, sizeof(uint64_t) * 2, 4, NULL));
+
+	FileVectorHeader header;
+	fd = open(path, O_RDWR);
+	assert(fd >= 0);
+	assert(pread(fd, &header, sizeof(header), 0) == sizeof(header));
+
+	FileVectorHeader changed = header;
+	changed.version = FVECTOR_VERSION + 1;
+	assert(pwrite(fd, &changed, sizeof(changed), 0) == sizeof(changed));
+	assert(!fvector_open(path, sizeof(uint64_t), 4, NULL));
+
+	changed = header;
+	changed.magic = ~header.magic;
+	assert(pwrite(fd, &changed, sizeof(changed), 0) == sizeof(changed));
+	assert(!fvector_open(path, sizeof(uint64_t), 4, NULL));
+
+	// The untouched header opens again
+	assert(pwrite(fd, &header, sizeof(header), 0) == sizeof(header));
+	close(fd);
+	fvector = fvector_open(path, sizeof(uint64_t), 4, NULL);
+	assert(fvector);
+	fvector_close(fvector);
+
+	unlink(path);
+}
+
+int main(int argc, char** argv) {
+	add_own_element();
+	reopen();
+	reject_mismatch();
+
+	printf("fvector_test: ok\n");
+	return 0;
+}
@@ -0,0 +1,168 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "map.h"
+
+#define COUNT		10000
+
+// Entries returned by map_get_or_insert stay valid and in place while the table grows
+static void get_or_insert() {
+	Map* map = map_create(1, NULL, NULL, NULL);
+	assert(map);
+
+	MapEntry** entries = malloc(sizeof(MapEntry*) * COUNT);
+	for(uintptr_t key = 1; key <= COUNT; key++) {
+		bool inserted = false;
+		MapEntry* entry = map_get_or_insert(map, (void*)key, (void*)(key * 2), &inserted);
+		assert(entry && inserted);
+		assert(entry->key == (void*)key && entry->data == (void*)(key * 2));
+		entries[key - 1] = entry;
+	}
+	assert(map_size(map) == COUNT);
+	assert(map_capacity(map) >= COUNT);
+
+	// Existing keys return the same entries, untouched, and inserted is cleared
+	for(uintptr_t key = 1; key <= COUNT; key++) {
+		bool inserted = true;
+		MapEntry* entry = map_get_or_insert(map, (void*)key, (void*)1, &inserted);
+		assert(entry == entries[key - 1] && !inserted);
+		assert(entry->data == (void*)(key * 2));
+
+		// Modified in place
+		entry->data = (void*)(key * 3);
+		assert(map_get(map, (void*)key) == (void*)(key * 3));
+	}
+	assert(map_size(map) == COUNT);
+
+	// inserted can be NULL
+	assert(map_get_or_insert(map, (void*)(COUNT + 1), (void*)1, NULL));
+	assert(map_get(map, (void*)(COUNT + 1)) == (void*)1);
+
+	free(entries);
+	map_destroy(map);
+}
+
+// Upsert puts new keys and replaces data of existing ones
+static void upsert() {
+	Map* map = map_create(4, NULL, NULL, NULL);
+	assert(map);
+
+	for(uintptr_t key = 1; key <= COUNT; key++)
+		assert(map_upsert(map, (void*)key, (void*)key));
+	assert(map_size(map) == COUNT);
+
+	for(uintptr_t key = 1; key <= COUNT; key += 2)
+		assert(map_upsert(map, (void*)key, (void*)(key + 1)));
+	assert(map_size(map) == COUNT);
+
+	for(uintptr_t key = 1; key <= COUNT; key++)
+		assert(map_get(map, (void*)key) == (void*)(key % 2 ? key + 1 : key));
+
+	map_destroy(map);
+}
+
+// Counts up to the limit in the context, then removes the element by returning NULL
+static void* count(void* key, void* data, void* context) {
+	uintptr_t limit = *(uintptr_t*)context;
+	uintptr_t value = (uintptr_t)data + 1;
+
+	return value > limit ? NULL : (void*)value;
+}
+
+// Returns NULL without an element, so nothing is put
+static void* never(void* key, void* data, void* context) {
+	(*(int*)context)++;
+	assert(!data);
+	return NULL;
+}
+
+static void compute() {
+	Map* map = map_create(1, NULL, NULL, NULL);
+	assert(map);
+
+	// Absent keys are put, present ones updated, while the table grows
+	uintptr_t limit = 3;
+	for(int round = 0; round < 3; round++) {
+		for(uintptr_t key = 1; key <= COUNT; key++)
+			assert(map_compute(map, (void*)key, count, &limit));
+		assert(map_size(map) == COUNT);
+	}
+	for(uintptr_t key = 1; key <= COUNT; key++)
+		assert(map_get(map, (void*)key) == (void*)3);
+
+	// A NULL result removes every element
+	for(uintptr_t key = 1; key <= COUNT; key++)
+		assert(map_compute(map, (void*)key, count, &limit));
+	assert(map_is_empty(map));
+	for(uintptr_t key = 1; key <= COUNT; key++)
+		assert(!map_contains(map, (void*)key));
+
+	// A NULL result for an absent key leaves the map unchanged
+	int calls = 0;
+	assert(map_compute(map, (void*)1, never, &calls));
+	assert(calls == 1);
+	assert(map_is_empty(map));
+	assert(!map_contains(map, (void*)1));
+
+	map_destroy(map);
+}
+
+// Few distinct hashes, so buckets hold many entries
+static uint64_t colliding_hash(void* key) {
+	return (uintptr_t)key % 7;
+}
+
+// map_get_batch agrees with map_get for hits, misses and a mix, at any count against MAP_BATCH_GROUP
+static void get_batch() {
+	for(int colliding = 0; colliding < 2; colliding++) {
+		Map* map = map_create(4, colliding ? colliding_hash : NULL, NULL, NULL);
+		assert(map);
+
+		// Odd keys are present
+		for(uintptr_t key = 1; key <= 1000; key += 2)
+			assert(map_put(map, (void*)key, (void*)(key * 2)));
+
+		static const size_t counts[] = { 0, 1, MAP_BATCH_GROUP - 1, MAP_BATCH_GROUP, MAP_BATCH_GROUP * 3 + 7 };
+		for(size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+			size_t count = counts[c];
+			void* keys[MAP_BATCH_GROUP * 4];
+			void* datas[MAP_BATCH_GROUP * 4 + 1];
+
+			// All hits, all misses, then a mix
+			for(int kind = 0; kind < 3; kind++) {
+				for(size_t i = 0; i < count; i++) {
+					uintptr_t key = (i * 37) % 500 * 2 + 1;
+					if(kind == 1 || (kind == 2 && i % 3 == 0))
+						key++;
+					keys[i] = (void*)key;
+				}
+
+				datas[count] = (void*)-1;
+				size_t found = map_get_batch(map, keys, datas, count);
+				assert(datas[count] == (void*)-1);
+
+				size_t expected = 0;
+				for(size_t i = 0; i < count; i++) {
+					assert(datas[i] == map_get(map, keys[i]));
+					expected += datas[i] != NULL;
+				}
+				assert(found == expected);
+				assert(kind != 0 || found == count);
+				assert(kind != 1 || found == 0);
+			}
+		}
+
+		map_destroy(map);
+	}
+}
+
+int main(int argc, char** argv) {
+	get_or_insert();
+	upsert();
+	compute();
+	get_batch();
+
+	printf("map_test: ok\n");
+	return 0;
+}
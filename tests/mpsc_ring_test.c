@@ -0,0 +1,128 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <sched.h>
+#include <pthread.h>
+#include <assert.h>
+#include "mpsc_ring.h"
+
+#define PRODUCERS	4
+#define COUNT		50000
+
+static MPSCRing* ring;
+
+// Message: producer id, sequence number, payload length, then the payload
+typedef struct {
+	uint32_t	producer;
+	uint32_t	seq;
+	uint32_t	len;
+} Message;
+
+static size_t length(uint32_t producer, uint32_t seq) {
+	return (seq * 31 + producer * 7) % 100;
+}
+
+static void* produce(void* arg) {
+	uint32_t producer = (uintptr_t)arg;
+	char data[sizeof(Message) + 100];
+	for(uint32_t seq = 0; seq < COUNT; seq++) {
+		Message message = { producer, seq, length(producer, seq) };
+		memcpy(data, &message, sizeof(message));
+		memset(data + sizeof(message), (char)(producer + seq), message.len);
+
+		while(!mpsc_ring_write(ring, data, sizeof(message) + message.len))
+			sched_yield();
+	}
+
+	return NULL;
+}
+
+static void read_fully(char* data, size_t len) {
+	size_t read = 0;
+	while(read < len) {
+		size_t n = mpsc_ring_read(ring, data + read, len - read);
+		if(n == 0)
+			sched_yield();
+		read += n;
+	}
+}
+
+// Writes of all producers arrive whole, unmixed and in per-producer order
+static void many_producers() {
+	ring = mpsc_ring_create(4096, NULL);
+	assert(ring);
+
+	pthread_t producers[PRODUCERS];
+	for(uintptr_t i = 0; i < PRODUCERS; i++)
+		pthread_create(&producers[i], NULL, produce, (void*)i);
+
+	uint32_t next[PRODUCERS] = { 0 };
+	for(int i = 0; i < PRODUCERS * COUNT; i++) {
+		Message message;
+		read_fully((char*)&message, sizeof(message));
+		assert(message.producer < PRODUCERS);
+		assert(message.seq == next[message.producer]++);
+		assert(message.len == length(message.producer, message.seq));
+
+		char payload[100];
+		read_fully(payload, message.len);
+		for(size_t j = 0; j < message.len; j++)
+			assert(payload[j] == (char)(message.producer + message.seq));
+	}
+
+	for(int i = 0; i < PRODUCERS; i++)
+		pthread_join(producers[i], NULL);
+	assert(mpsc_ring_empty(ring));
+
+	mpsc_ring_destroy(ring);
+}
+
+// A write which does not fit writes nothing
+static void all_or_nothing() {
+	ring = mpsc_ring_create(64, NULL);
+	assert(ring);
+
+	char data[64] = { 0 };
+	assert(!mpsc_ring_write(ring, data, 64));
+	assert(mpsc_ring_write(ring, data, 40));
+	assert(!mpsc_ring_write(ring, data, 40));
+	assert(mpsc_ring_read(ring, data, 64) == 40);
+	assert(mpsc_ring_empty(ring));
+
+	mpsc_ring_destroy(ring);
+}
+
+// Buffers below MPSC_RING_MIN_SIZE are rejected, the minimum holds 8 bytes
+static void min_size() {
+	MPSCRing r;
+	uint64_t buf[4];
+	char data[16];
+	assert(!mpsc_ring_init(&r, (char*)buf, 0));
+	assert(!mpsc_ring_init(&r, (char*)buf, 8));
+	assert(!mpsc_ring_init(&r, (char*)buf, MPSC_RING_MIN_SIZE - 1));
+	assert(mpsc_ring_init(&r, (char*)buf, MPSC_RING_MIN_SIZE + 8));
+	assert(r.size == MPSC_RING_MIN_SIZE);
+
+	assert(!mpsc_ring_write(&r, "123456789", 9));
+	for(int i = 0; i < 3; i++) {
+		assert(mpsc_ring_write(&r, "12345678", 8));
+		assert(!mpsc_ring_write(&r, "", 0));
+		assert(mpsc_ring_read(&r, data, sizeof(data)) == 8);
+		assert(memcmp(data, "12345678", 8) == 0);
+		assert(mpsc_ring_empty(&r));
+	}
+
+	// create rounds a smaller size up
+	ring = mpsc_ring_create(1, NULL);
+	assert(ring && ring->size == MPSC_RING_MIN_SIZE);
+	mpsc_ring_destroy(ring);
+}
+
+int main(int argc, char** argv) {
+	many_producers();
+	all_or_nothing();
+	min_size();
+
+	printf("mpsc_ring_test: ok\n");
+	return 0;
+}
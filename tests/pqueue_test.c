@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "pqueue.h"
+#include "test.h"
+
+#define COUNT		5000
+
+// Priorities are unique as the element id is in the low bits, so the pop order is fixed
+#define PRIORITY(rank, id)	((uint64_t)(rank) << 20 | (id))
+
+typedef struct {
+	uint64_t	priority;
+	size_t		handle;
+	bool		live;
+} Element;
+
+static Element elements[COUNT];
+
+// The live element with the lowest priority, by scanning the reference
+static uintptr_t lowest() {
+	uintptr_t best = COUNT;
+	for(uintptr_t id = 0; id < COUNT; id++) {
+		if(elements[id].live && (best == COUNT || elements[id].priority < elements[best].priority))
+			best = id;
+	}
+
+	return best;
+}
+
+// Decrease-key and remove-by-handle anywhere in the heap, every pop checked against a linear scan of the live elements
+static void decrease_remove() {
+	PriorityQueue* pqueue = pqueue_create(COUNT / 4, NULL);
+	assert(pqueue);
+
+	for(uintptr_t id = 0; id < COUNT; id++) {
+		if(!pqueue_available(pqueue))
+			assert(pqueue_resize(pqueue, pqueue_capacity(pqueue) * 2));
+
+		elements[id].priority = PRIORITY(test_random() % 1000000 + 1000000, id);
+		elements[id].handle = pqueue_push(pqueue, elements[id].priority, (void*)id);
+		assert(elements[id].handle != (size_t)-1);
+		elements[id].live = true;
+	}
+
+	for(int round = 0; round < COUNT * 2; round++) {
+		uintptr_t id = test_random() % COUNT;
+		Element* element = &elements[id];
+
+		switch(test_random() % 4) {
+			case 0:
+			case 1:
+				// Decrease to anywhere in the heap, even below the current minimum
+				if(!element->live || element->priority >> 20 == 0)
+					break;
+
+				uint64_t rank = element->priority >> 20;
+				uint64_t priority = PRIORITY(test_random() % rank, id);
+				assert(!pqueue_decrease(pqueue, element->handle, element->priority + (1 << 20)));
+				assert(pqueue_decrease(pqueue, element->handle, priority));
+				element->priority = priority;
+				break;
+			case 2:
+				if(!element->live)
+					break;
+
+				assert(pqueue_remove(pqueue, element->handle) == (void*)id);
+				element->live = false;
+				break;
+			default:
+				// Pop now and then, so removes and decreases see handles moved by pops
+				if(pqueue_empty(pqueue))
+					break;
+
+				uintptr_t expected = lowest();
+				assert(pqueue_peek(pqueue)->priority == elements[expected].priority);
+				assert(pqueue_pop(pqueue) == (void*)expected);
+				elements[expected].live = false;
+		}
+	}
+
+	size_t live = 0;
+	for(uintptr_t id = 0; id < COUNT; id++)
+		live += elements[id].live;
+	assert(pqueue_size(pqueue) == live);
+
+	// The rest pops in priority order
+	while(!pqueue_empty(pqueue)) {
+		uintptr_t expected = lowest();
+		assert(pqueue_pop(pqueue) == (void*)expected);
+		elements[expected].live = false;
+	}
+	assert(lowest() == COUNT);
+	assert(!pqueue_pop(pqueue));
+	assert(!pqueue_peek(pqueue));
+
+	pqueue_destroy(pqueue);
+}
+
+// Heapified entries pop in priority order along with pushed ones
+static void heapify() {
+	PriorityQueue* pqueue = pqueue_create(COUNT * 2, NULL);
+	assert(pqueue);
+
+	PriorityQueueEntry* entries = malloc(sizeof(PriorityQueueEntry) * COUNT);
+	for(uintptr_t id = 0; id < COUNT; id++) {
+		elements[id].priority = PRIORITY(test_random() % 1000000, id);
+		elements[id].live = true;
+		if(id % 2) {
+			entries[id / 2].priority = elements[id].priority;
+			entries[id / 2].data = (void*)id;
+		} else {
+			assert(pqueue_push(pqueue, elements[id].priority, (void*)id) != (size_t)-1);
+		}
+	}
+	assert(pqueue_heapify(pqueue, entries, COUNT / 2));
+	assert(pqueue_size(pqueue) == COUNT);
+
+	while(!pqueue_empty(pqueue)) {
+		uintptr_t expected = lowest();
+		assert(pqueue_pop(pqueue) == (void*)expected);
+		elements[expected].live = false;
+	}
+
+	free(entries);
+	pqueue_destroy(pqueue);
+}
+
+int main(int argc, char** argv) {
+	decrease_remove();
+	heapify();
+
+	printf("pqueue_test: ok\n");
+	return 0;
+}
@@ -0,0 +1,253 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "radix.h"
+#include "test.h"
+
+#define KEY_MAX		48
+#define ROUNDS		100000
+
+typedef struct {
+	uint8_t		bytes[KEY_MAX];
+	size_t		len;
+	bool		present;
+} Key;
+
+// Byte order, a key sorts right before the keys it is a prefix of
+static int key_compare(const void* a, const void* b) {
+	const Key* k1 = a;
+	const Key* k2 = b;
+	int result = memcmp(k1->bytes, k2->bytes, k1->len < k2->len ? k1->len : k2->len);
+	if(result)
+		return result;
+
+	return (k1->len > k2->len) - (k1->len < k2->len);
+}
+
+static Key* keys;
+static size_t key_count;
+
+// Keys sharing prefixes of 0 up to 40 bytes, around and across RADIX_PREFIX_MAX,
+// followed by a byte taking any of 256 values so nodes go through every layout,
+// and keys which are prefixes of other keys including the empty key
+static void generate() {
+	static const size_t prefixes[] = { 0, 1, 5, RADIX_PREFIX_MAX - 1, RADIX_PREFIX_MAX, RADIX_PREFIX_MAX + 1, 23, 40 };
+	size_t size = 0;
+	keys = malloc(sizeof(Key) * 8192);
+
+	for(size_t p = 0; p < sizeof(prefixes) / sizeof(prefixes[0]); p++) {
+		for(size_t i = 0; i < 1000; i++) {
+			Key* key = &keys[size++];
+			memset(key->bytes, 'p', prefixes[p]);
+			key->len = prefixes[p];
+
+			// Fan-out byte, then 0 to 6 more bytes from a small alphabet so that suffixes repeat
+			size_t fanout = i < 256 ? i : test_random() % (p % 2 ? 20 : 256);
+			if(i < 900)
+				key->bytes[key->len++] = fanout;
+			size_t extra = test_random() % 7;
+			for(size_t j = 0; j < extra && key->len < KEY_MAX; j++)
+				key->bytes[key->len++] = 'a' + test_random() % 3;
+		}
+	}
+
+	// Unique keys only
+	qsort(keys, size, sizeof(Key), key_compare);
+	key_count = 0;
+	for(size_t i = 0; i < size; i++) {
+		if(key_count == 0 || key_compare(&keys[key_count - 1], &keys[i]) != 0)
+			keys[key_count++] = keys[i];
+	}
+	for(size_t i = 0; i < key_count; i++)
+		keys[i].present = false;
+}
+
+static void* value(size_t index) {
+	return (void*)(index + 1);
+}
+
+typedef struct {
+	size_t		index;		///< Next key expected in the reference
+	size_t		count;		///< Keys visited
+	const Key*	prefix;		///< Prefix iterated
+} Walk;
+
+static bool has_prefix(const Key* key, const Key* prefix) {
+	return key->len >= prefix->len && memcmp(key->bytes, prefix->bytes, prefix->len) == 0;
+}
+
+static bool visit(const void* bytes, size_t len, void* data, void* context) {
+	Walk* walk = context;
+	while(walk->index < key_count && (!keys[walk->index].present || !has_prefix(&keys[walk->index], walk->prefix)))
+		walk->index++;
+
+	assert(walk->index < key_count);
+	Key* key = &keys[walk->index];
+	assert(len == key->len && memcmp(bytes, key->bytes, len) == 0);
+	assert(data == value(walk->index));
+
+	walk->index++;
+	walk->count++;
+	return true;
+}
+
+// Iteration under a prefix yields exactly the present keys with the prefix, in byte order
+static void check_iterate(RadixTree* radix, const Key* prefix) {
+	Walk walk = { .index = 0, .count = 0, .prefix = prefix };
+	assert(radix_iterate_prefix(radix, prefix->bytes, prefix->len, visit, &walk));
+
+	size_t expected = 0;
+	for(size_t i = 0; i < key_count; i++) {
+		if(keys[i].present && has_prefix(&keys[i], prefix))
+			expected++;
+	}
+	assert(walk.count == expected);
+}
+
+// Longest prefix match against a scan of the reference
+static void check_longest_prefix(RadixTree* radix, const Key* probe) {
+	size_t best = SIZE_MAX;
+	for(size_t i = 0; i < key_count; i++) {
+		if(keys[i].present && has_prefix(probe, &keys[i]) && (best == SIZE_MAX || keys[i].len > keys[best].len))
+			best = i;
+	}
+
+	size_t matched = SIZE_MAX;
+	void* data = radix_longest_prefix(radix, probe->bytes, probe->len, &matched);
+	if(best == SIZE_MAX) {
+		assert(!data && matched == SIZE_MAX);
+	} else {
+		assert(data == value(best));
+		assert(matched == keys[best].len);
+	}
+}
+
+static void check_all(RadixTree* radix) {
+	size_t count = 0;
+	for(size_t i = 0; i < key_count; i++) {
+		assert(radix_get(radix, keys[i].bytes, keys[i].len) == (keys[i].present ? value(i) : NULL));
+		count += keys[i].present;
+	}
+	assert(radix_size(radix) == count);
+
+	Key empty = { .len = 0 };
+	check_iterate(radix, &empty);
+}
+
+// Random puts and removes grow and shrink nodes, split and merge prefixes
+static void random_put_remove() {
+	RadixTree* radix = radix_create(NULL);
+	assert(radix);
+
+	for(int round = 0; round < ROUNDS; round++) {
+		size_t index = test_random() % key_count;
+		Key* key = &keys[index];
+
+		// Grow for the first half, shrink for the second half
+		bool put = test_random() % 4 < (round < ROUNDS / 2 ? 3 : 1);
+		if(put) {
+			assert(radix_put(radix, key->bytes, key->len, value(index)) == !key->present);
+			key->present = true;
+		} else {
+			assert(radix_remove(radix, key->bytes, key->len) == (key->present ? value(index) : NULL));
+			key->present = false;
+		}
+		assert(radix_contains(radix, key->bytes, key->len) == key->present);
+
+		if(round % 5000 == 0) {
+			check_all(radix);
+
+			// Prefixes cut anywhere in a key, including in the middle of a compressed prefix
+			for(int i = 0; i < 20; i++) {
+				Key prefix = keys[test_random() % key_count];
+				prefix.len = test_random() % (prefix.len + 1);
+				check_iterate(radix, &prefix);
+				check_longest_prefix(radix, &keys[test_random() % key_count]);
+			}
+		}
+	}
+	check_all(radix);
+
+	// Shrinking all the way down to an empty tree
+	for(size_t i = 0; i < key_count; i++) {
+		if(!keys[i].present)
+			continue;
+
+		assert(radix_remove(radix, keys[i].bytes, keys[i].len) == value(i));
+		keys[i].present = false;
+		if(i % 500 == 0)
+			check_all(radix);
+	}
+	assert(radix_is_empty(radix));
+	check_all(radix);
+
+	radix_destroy(radix);
+}
+
+// Every key put in byte order, removed in reverse and put again
+static void sequential() {
+	RadixTree* radix = radix_create(NULL);
+	assert(radix);
+
+	for(size_t i = 0; i < key_count; i++) {
+		assert(radix_put(radix, keys[i].bytes, keys[i].len, value(i)));
+		keys[i].present = true;
+	}
+	check_all(radix);
+
+	for(size_t i = key_count; i-- > 0;) {
+		assert(radix_remove(radix, keys[i].bytes, keys[i].len) == value(i));
+		keys[i].present = false;
+	}
+	assert(radix_is_empty(radix));
+
+	for(size_t i = 0; i < key_count; i += 2) {
+		assert(radix_put(radix, keys[i].bytes, keys[i].len, NULL));
+		assert(radix_update(radix, keys[i].bytes, keys[i].len, value(i)));
+		keys[i].present = true;
+	}
+	check_all(radix);
+
+	radix_destroy(radix);
+	for(size_t i = 0; i < key_count; i++)
+		keys[i].present = false;
+}
+
+// Integer keys iterate in numeric order
+static bool count_ascending(const void* key, size_t len, void* data, void* context) {
+	uint64_t* last = context;
+	assert(len == 8);
+	assert((uint64_t)(uintptr_t)data >= *last);
+	*last = (uintptr_t)data;
+	return true;
+}
+
+static void integer_keys() {
+	RadixTree* radix = radix_create(NULL);
+	assert(radix);
+
+	uint8_t key[8];
+	for(int i = 0; i < 10000; i++) {
+		uint64_t number = test_random() >> 8;
+		radix_uint64_key(number, key);
+		radix_put(radix, key, sizeof(key), (void*)(uintptr_t)number);
+	}
+
+	uint64_t last = 0;
+	assert(radix_iterate_prefix(radix, NULL, 0, count_ascending, &last));
+
+	radix_destroy(radix);
+}
+
+int main(int argc, char** argv) {
+	generate();
+	sequential();
+	random_put_remove();
+	integer_keys();
+
+	free(keys);
+	printf("radix_test: ok\n");
+	return 0;
+}
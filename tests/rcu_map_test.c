@@ -0,0 +1,101 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <assert.h>
+#include "rcu_map.h"
+
+#define STABLE		64
+#define VOLATILE	256
+#define ROUNDS		8
+#define READERS		4
+
+static RCUMap* map;
+static volatile bool done;
+
+// Data of a key is its number shifted by one bit, the low bit is the version
+static void* data_of(uintptr_t key, int version) {
+	return (void*)(key << 1 | version);
+}
+
+static void* read_all(void* arg) {
+	uint64_t lookups = 0;
+	while(!__atomic_load_n(&done, __ATOMIC_ACQUIRE)) {
+		for(uintptr_t key = 1; key <= STABLE + VOLATILE; key++) {
+			uintptr_t data = (uintptr_t)rcu_map_get(map, (void*)key);
+			if(key <= STABLE)
+				assert(data >> 1 == key);
+			else
+				assert(data == 0 || data >> 1 == key);
+
+			lookups++;
+		}
+	}
+
+	return (void*)lookups;
+}
+
+// Readers see stable keys through updates, growth and removal of their neighbours
+static void read_while_writing() {
+	map = rcu_map_create(4, NULL, NULL, NULL);
+	assert(map);
+
+	for(uintptr_t key = 1; key <= STABLE; key++)
+		assert(rcu_map_put(map, (void*)key, data_of(key, 0)));
+
+	pthread_t threads[READERS];
+	for(int i = 0; i < READERS; i++)
+		pthread_create(&threads[i], NULL, read_all, NULL);
+
+	for(int round = 0; round < ROUNDS; round++) {
+		for(uintptr_t key = STABLE + 1; key <= STABLE + VOLATILE; key++)
+			assert(rcu_map_put(map, (void*)key, data_of(key, 0)));
+
+		for(uintptr_t key = 1; key <= STABLE; key++)
+			assert(rcu_map_update(map, (void*)key, data_of(key, round & 1)) == data_of(key, round ? (round - 1) & 1 : 0));
+
+		// The old data could be freed from here
+		rcu_map_synchronize(map);
+
+		// Removed nodes are freed while readers may be walking the buckets
+		for(uintptr_t key = STABLE + 1; key <= STABLE + VOLATILE; key++)
+			assert(rcu_map_remove(map, (void*)key) == data_of(key, 0));
+
+		assert(rcu_map_size(map) == STABLE);
+	}
+
+	__atomic_store_n(&done, true, __ATOMIC_RELEASE);
+	for(int i = 0; i < READERS; i++)
+		pthread_join(threads[i], NULL);
+
+	rcu_map_destroy(map);
+}
+
+// Single thread semantics of put, update, get and remove
+static void basic() {
+	map = rcu_map_create(1, NULL, NULL, NULL);
+	assert(map);
+	assert(rcu_map_is_empty(map));
+
+	assert(rcu_map_put(map, (void*)1, data_of(1, 0)));
+	assert(!rcu_map_put(map, (void*)1, data_of(1, 1)));
+	assert(rcu_map_get(map, (void*)1) == data_of(1, 0));
+	assert(rcu_map_update(map, (void*)1, data_of(1, 1)) == data_of(1, 0));
+	assert(rcu_map_get(map, (void*)1) == data_of(1, 1));
+	assert(rcu_map_update(map, (void*)2, data_of(2, 0)) == NULL);
+	rcu_map_synchronize(map);
+	assert(!rcu_map_contains(map, (void*)2));
+
+	assert(rcu_map_remove(map, (void*)1) == data_of(1, 1));
+	assert(rcu_map_remove(map, (void*)1) == NULL);
+	assert(rcu_map_is_empty(map));
+
+	rcu_map_destroy(map);
+}
+
+int main(int argc, char** argv) {
+	basic();
+	read_while_writing();
+
+	printf("rcu_map_test: ok\n");
+	return 0;
+}
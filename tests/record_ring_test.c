@@ -0,0 +1,150 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <sched.h>
+#include <pthread.h>
+#include <assert.h>
+#include "record_ring.h"
+
+#define COUNT		200000
+#define BATCH		16
+
+static RecordRing* rring;
+
+// Length and contents of a record are derived from its sequence number
+static size_t length(uint32_t seq) {
+	return sizeof(uint32_t) + (seq * 7919) % 300;
+}
+
+static void fill(char* record, uint32_t seq) {
+	memcpy(record, &seq, sizeof(seq));
+	for(size_t i = sizeof(seq); i < length(seq); i++)
+		record[i] = (char)(seq + i);
+}
+
+static void check(const struct iovec* record, uint32_t seq) {
+	assert(record->iov_len == length(seq));
+	assert(((uintptr_t)record->iov_base & (RECORD_RING_ALIGN - 1)) == 0);
+
+	const char* data = record->iov_base;
+	assert(memcmp(data, &seq, sizeof(seq)) == 0);
+	for(size_t i = sizeof(seq); i < record->iov_len; i++)
+		assert(data[i] == (char)(seq + i));
+}
+
+// Alternates record_ring_write and record_ring_reserve/record_ring_commit
+static void* produce(void* arg) {
+	char record[512];
+	for(uint32_t seq = 0; seq < COUNT; seq++) {
+		if(seq & 1) {
+			void* space;
+			while(!(space = record_ring_reserve(rring, length(seq))))
+				sched_yield();
+
+			fill(space, seq);
+			record_ring_commit(rring);
+		} else {
+			fill(record, seq);
+			while(!record_ring_write(rring, record, length(seq)))
+				sched_yield();
+		}
+	}
+
+	return NULL;
+}
+
+// Records arrive whole and in order across wraps while being read in batches
+static void stream() {
+	rring = record_ring_create(4096, NULL);
+	assert(rring);
+
+	pthread_t producer;
+	pthread_create(&producer, NULL, produce, NULL);
+
+	struct iovec records[BATCH];
+	uint32_t seq = 0;
+	while(seq < COUNT) {
+		size_t count = record_ring_read_batch(rring, records, BATCH);
+		for(size_t i = 0; i < count; i++)
+			check(&records[i], seq++);
+
+		// Reading again continues after the records already handed out
+		if(count == BATCH) {
+			count = record_ring_read_batch(rring, records, 1);
+			if(count)
+				check(&records[0], seq++);
+		}
+
+		record_ring_release(rring);
+		if(count == 0)
+			sched_yield();
+	}
+	pthread_join(producer, NULL);
+
+	assert(record_ring_empty(rring));
+	record_ring_destroy(rring);
+}
+
+// A write is all or nothing
+static void all_or_nothing() {
+	rring = record_ring_create(64, NULL);
+	assert(rring);
+
+	char record[64] = { 0 };
+	assert(!record_ring_write(rring, record, 64));
+	assert(record_ring_empty(rring));
+	assert(record_ring_write(rring, record, 40));
+	assert(!record_ring_write(rring, record, 40));
+
+	struct iovec records[2];
+	assert(record_ring_read_batch(rring, records, 2) == 1);
+	assert(records[0].iov_len == 40);
+	record_ring_release(rring);
+	assert(record_ring_empty(rring));
+
+	record_ring_destroy(rring);
+}
+
+// A record larger than half of the buffer fits after a wrap once the skip marker is consumed
+static void large_after_wrap() {
+	rring = record_ring_create(4096, NULL);
+	assert(rring);
+
+	static char record[4096];
+	struct iovec records[2];
+	assert(record_ring_write(rring, record, 1992));
+	assert(record_ring_read_batch(rring, records, 2) == 1);
+	record_ring_release(rring);
+	assert(record_ring_empty(rring));
+
+	for(uint32_t seq = 0; seq < 8; seq++) {
+		size_t len = 3000 + seq * 8;
+		memcpy(record, &seq, sizeof(seq));
+		for(size_t i = sizeof(seq); i < len; i++)
+			record[i] = (char)(seq + i);
+
+		// The first attempt may only publish the skip marker over the tail
+		if(!record_ring_write(rring, record, len)) {
+			assert(record_ring_read_batch(rring, records, 2) == 0);
+			record_ring_release(rring);
+			assert(record_ring_write(rring, record, len));
+		}
+
+		assert(record_ring_read_batch(rring, records, 2) == 1);
+		assert(records[0].iov_len == len);
+		assert(memcmp(records[0].iov_base, record, len) == 0);
+		record_ring_release(rring);
+		assert(record_ring_empty(rring));
+	}
+
+	record_ring_destroy(rring);
+}
+
+int main(int argc, char** argv) {
+	stream();
+	all_or_nothing();
+	large_after_wrap();
+
+	printf("record_ring_test: ok\n");
+	return 0;
+}
@@ -0,0 +1,284 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sched.h>
+#include <pthread.h>
+#include <assert.h>
+#include "ring.h"
+
+#define TOTAL		(4 * 1024 * 1024)
+#define CHUNK		1000
+
+static Ring* ring;
+
+static inline char pattern(uint64_t position) {
+	return (char)(position * 131 + (position >> 9));
+}
+
+static size_t chunk(unsigned int* seed) {
+	return rand_r(seed) % CHUNK + 1;
+}
+
+// Alternates ring_push and ring_write_reserve/ring_write_commit with odd lengths
+static void* produce(void* arg) {
+	unsigned int seed = 1;
+	char data[CHUNK];
+	uint64_t position = 0;
+	bool reserve = false;
+
+	while(position < TOTAL) {
+		size_t len = chunk(&seed);
+		if(len > TOTAL - position)
+			len = TOTAL - position;
+
+		size_t written;
+		if(reserve) {
+			struct iovec vec[2];
+			written = ring_write_reserve(ring, vec, len);
+			assert(vec[0].iov_len + vec[1].iov_len == written);
+			for(size_t i = 0; i < vec[0].iov_len; i++)
+				((char*)vec[0].iov_base)[i] = pattern(position + i);
+			for(size_t i = 0; i < vec[1].iov_len; i++)
+				((char*)vec[1].iov_base)[i] = pattern(position + vec[0].iov_len + i);
+			ring_write_commit(ring, written);
+		} else {
+			for(size_t i = 0; i < len; i++)
+				data[i] = pattern(position + i);
+			written = ring_push(ring, data, len);
+		}
+
+		assert(written <= len);
+		position += written;
+		reserve = !reserve;
+		if(written == 0)
+			sched_yield();
+	}
+
+	return NULL;
+}
+
+// Alternates ring_pop and ring_read_peek/ring_read_consume, checking every byte
+static void consume() {
+	unsigned int seed = 2;
+	char data[CHUNK];
+	uint64_t position = 0;
+	bool peek = false;
+
+	while(position < TOTAL) {
+		size_t len = chunk(&seed);
+
+		size_t read;
+		if(peek) {
+			struct iovec vec[2];
+			read = ring_read_peek(ring, vec, len);
+			assert(vec[0].iov_len + vec[1].iov_len == read);
+			for(size_t i = 0; i < vec[0].iov_len; i++)
+				assert(((char*)vec[0].iov_base)[i] == pattern(position + i));
+			for(size_t i = 0; i < vec[1].iov_len; i++)
+				assert(((char*)vec[1].iov_base)[i] == pattern(position + vec[0].iov_len + i));
+			ring_read_consume(ring, read);
+		} else {
+			read = ring_pop(ring, data, len);
+			for(size_t i = 0; i < read; i++)
+				assert(data[i] == pattern(position + i));
+		}
+
+		assert(read <= len);
+		position += read;
+		peek = !peek;
+		if(read == 0)
+			sched_yield();
+	}
+}
+
+static volatile bool streaming;
+
+// A third thread sees head and tail at different times, sizes stay in range
+static void* observe(void* arg) {
+	size_t capacity = ring_capacity(ring);
+	while(streaming) {
+		assert(ring_size(ring) <= capacity);
+		assert(ring_space(ring) <= capacity);
+	}
+
+	return NULL;
+}
+
+// One producer thread and one consumer thread stream bytes through the Ring
+static void stream(Ring* r, bool mirrored) {
+	ring = r;
+	assert(ring);
+	size_t capacity = ring_capacity(ring);
+	assert(capacity >= 4096 && (capacity & (capacity - 1)) == 0);
+
+	pthread_t producer;
+	pthread_t observer;
+	streaming = true;
+	pthread_create(&producer, NULL, produce, NULL);
+	pthread_create(&observer, NULL, observe, NULL);
+	consume();
+	pthread_join(producer, NULL);
+	streaming = false;
+	pthread_join(observer, NULL);
+
+	assert(ring_empty(ring));
+	assert(ring_size(ring) == 0);
+	assert(ring_space(ring) == capacity);
+
+	if(mirrored) {
+		// The second span is always empty on a mirrored Ring
+		struct iovec vec[2];
+		ring_write_commit(ring, ring_write_reserve(ring, vec, 100));
+		ring_read_consume(ring, ring_read_peek(ring, vec, 100));
+		assert(ring_write_reserve(ring, vec, capacity) == capacity);
+		assert(vec[0].iov_len == capacity && vec[1].iov_len == 0);
+	}
+
+	ring_destroy(ring);
+}
+
+static char buf[4096];
+static volatile size_t head;
+static volatile size_t tail;
+
+static void* write_raw(void* arg) {
+	unsigned int seed = 3;
+	char data[CHUNK];
+	uint64_t position = 0;
+
+	while(position < TOTAL) {
+		size_t len = chunk(&seed);
+		if(len > TOTAL - position)
+			len = TOTAL - position;
+
+		for(size_t i = 0; i < len; i++)
+			data[i] = pattern(position + i);
+
+		size_t h = __atomic_load_n(&head, __ATOMIC_RELAXED);
+		ssize_t written = ring_write(buf, h, &tail, sizeof(buf), data, len);
+		assert(written >= 0);
+		position += written;
+		if(written == 0)
+			sched_yield();
+	}
+
+	return NULL;
+}
+
+// The raw-buffer ring_write and ring_read with free-running indices
+static void stream_raw() {
+	pthread_t writer;
+	pthread_create(&writer, NULL, write_raw, NULL);
+
+	unsigned int seed = 4;
+	char data[CHUNK];
+	uint64_t position = 0;
+	while(position < TOTAL) {
+		size_t t = __atomic_load_n(&tail, __ATOMIC_RELAXED);
+		assert(ring_readable(head, t) + ring_writable(head, t, sizeof(buf)) == sizeof(buf));
+
+		ssize_t read = ring_read(buf, &head, t, sizeof(buf), data, chunk(&seed));
+		assert(read >= 0);
+		for(ssize_t i = 0; i < read; i++)
+			assert(data[i] == pattern(position + i));
+
+		position += read;
+		if(read == 0)
+			sched_yield();
+	}
+
+	pthread_join(writer, NULL);
+	assert(head == TOTAL && tail == TOTAL);
+
+	// Free-running indices are masked, so any other size is rejected
+	size_t h = 0;
+	size_t t = 0;
+	assert(ring_write(buf, h, &t, 3000, data, 10) == -1);
+	assert(ring_write(buf, h, &t, 0, data, 10) == -1);
+	assert(ring_read(buf, &h, t, 3000, data, 10) == -1);
+	assert(h == 0 && t == 0);
+}
+
+static void write_pattern(int fd, uint64_t position, size_t len) {
+	char data[8192];
+	for(size_t i = 0; i < len; i++)
+		data[i] = pattern(position + i);
+	assert(write(fd, data, len) == len);
+}
+
+static void read_pattern(int fd, uint64_t position, size_t len) {
+	char data[8192];
+	assert(read(fd, data, len) == len);
+	for(size_t i = 0; i < len; i++)
+		assert(data[i] == pattern(position + i));
+}
+
+// Fill from a pipe and drain to a pipe across the end of the buffer, with short reads and writes
+static void fd(Ring* r) {
+	assert(r);
+	size_t capacity = ring_capacity(r);
+	assert(capacity == 8192);
+
+	int in[2];
+	int out[2];
+	assert(pipe(in) == 0 && pipe(out) == 0);
+
+	// The out pipe holds one page and does not block, so a drain bigger than that is short
+	assert(fcntl(out[1], F_SETFL, O_NONBLOCK) == 0);
+	size_t pipe_size = fcntl(out[1], F_SETPIPE_SZ, 4096);
+	assert(pipe_size == 4096);
+
+	// Indices near the end of the buffer, so the spans wrap
+	char data[8192];
+	assert(ring_push(r, data, 8000) == 8000);
+	assert(ring_pop(r, data, 8000) == 8000);
+
+	// Short read, the pipe has less than asked
+	write_pattern(in[1], 0, 1000);
+	assert(ring_fill_from_fd(r, in[0], capacity) == 1000);
+	assert(ring_size(r) == 1000);
+
+	// Only the space left is read, the rest stays in the pipe
+	write_pattern(in[1], 1000, 8000);
+	assert(ring_fill_from_fd(r, in[0], capacity) == capacity - 1000);
+	assert(ring_space(r) == 0);
+	assert(ring_fill_from_fd(r, in[0], capacity) == 0);
+
+	// Short writes, one page at a time
+	assert(ring_drain_to_fd(r, out[1], capacity) == pipe_size);
+	assert(ring_size(r) == capacity - pipe_size);
+	assert(ring_drain_to_fd(r, out[1], capacity) == -1);
+	assert(ring_size(r) == capacity - pipe_size);
+	read_pattern(out[0], 0, pipe_size);
+
+	assert(ring_drain_to_fd(r, out[1], capacity) == capacity - pipe_size);
+	read_pattern(out[0], pipe_size, capacity - pipe_size);
+	assert(ring_drain_to_fd(r, out[1], capacity) == 0);
+	assert(ring_empty(r));
+
+	// The rest of the input goes through after the wrap
+	assert(ring_fill_from_fd(r, in[0], capacity) == 9000 - capacity);
+	assert(ring_drain_to_fd(r, out[1], capacity) == 9000 - capacity);
+	read_pattern(out[0], capacity, 9000 - capacity);
+
+	close(in[0]);
+	close(in[1]);
+	close(out[0]);
+	close(out[1]);
+	ring_destroy(r);
+}
+
+int main(int argc, char** argv) {
+	stream(ring_create(4096, NULL), false);
+	stream(ring_create_mirrored(4096, NULL), true);
+	stream_raw();
+	fd(ring_create(8192, NULL));
+	fd(ring_create_mirrored(8192, NULL));
+
+	printf("ring_test: ok\n");
+	return 0;
+}
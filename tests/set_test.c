@@ -0,0 +1,60 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <assert.h>
+#include "set.h"
+
+// Few distinct hashes, so buckets hold many entries
+static uint64_t colliding_hash(void* data) {
+	return (uintptr_t)data % 7;
+}
+
+// set_contains_batch agrees with set_contains for hits, misses and a mix, at any count against SET_BATCH_GROUP
+static void contains_batch() {
+	for(int colliding = 0; colliding < 2; colliding++) {
+		Set* set = set_create(4, colliding ? colliding_hash : NULL, NULL, NULL);
+		assert(set);
+
+		// Odd elements are present
+		for(uintptr_t data = 1; data <= 1000; data += 2)
+			assert(set_put(set, (void*)data));
+
+		static const size_t counts[] = { 0, 1, SET_BATCH_GROUP - 1, SET_BATCH_GROUP, SET_BATCH_GROUP * 3 + 7 };
+		for(size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+			size_t count = counts[c];
+			void* datas[SET_BATCH_GROUP * 4];
+			bool results[SET_BATCH_GROUP * 4 + 1];
+
+			// All hits, all misses, then a mix
+			for(int kind = 0; kind < 3; kind++) {
+				for(size_t i = 0; i < count; i++) {
+					uintptr_t data = (i * 37) % 500 * 2 + 1;
+					if(kind == 1 || (kind == 2 && i % 3 == 0))
+						data++;
+					datas[i] = (void*)data;
+				}
+
+				results[count] = true;
+				size_t found = set_contains_batch(set, datas, results, count);
+				assert(results[count]);
+
+				size_t expected = 0;
+				for(size_t i = 0; i < count; i++) {
+					assert(results[i] == set_contains(set, datas[i]));
+					expected += results[i];
+				}
+				assert(found == expected);
+				assert(kind != 0 || found == count);
+				assert(kind != 1 || found == 0);
+			}
+		}
+
+		set_destroy(set);
+	}
+}
+
+int main(int argc, char** argv) {
+	contains_batch();
+
+	printf("set_test: ok\n");
+	return 0;
+}
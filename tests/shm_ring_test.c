@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <assert.h>
+#include "shm_ring.h"
+
+#define NAME		"/shm_ring_test"
+#define TOTAL		(16UL * 1024 * 1024)
+
+// Byte at a stream position
+static char pattern(uint64_t position) {
+	return (char)(position * 31 + (position >> 12));
+}
+
+// Reader process checks the stream, the exit status tells the result
+static int consume() {
+	ShmRing* ring = NULL;
+	while(!(ring = shm_ring_attach(NAME, SHM_RING_READER, NULL)))
+		sched_yield();
+
+	char data[3000];
+	uint64_t position = 0;
+	while(position < TOTAL) {
+		size_t len = shm_ring_read(ring, data, sizeof(data));
+		for(size_t i = 0; i < len; i++)
+			if(data[i] != pattern(position + i))
+				return 1;
+
+		position += len;
+		if(len == 0)
+			sched_yield();
+	}
+
+	int result = shm_ring_size(ring) == 0 ? 0 : 2;
+	shm_ring_destroy(ring);
+	return result;
+}
+
+// A stream written by one process arrives intact in another across wraps
+static void stream() {
+	shm_ring_unlink(NAME);
+	ShmRing* ring = shm_ring_create(NAME, 4096, SHM_RING_WRITER, NULL);
+	assert(ring);
+
+	pid_t pid = fork();
+	assert(pid >= 0);
+	if(pid == 0)
+		_exit(consume());
+
+	char data[1777];
+	uint64_t position = 0;
+	while(position < TOTAL) {
+		size_t len = sizeof(data) < TOTAL - position ? sizeof(data) : TOTAL - position;
+		for(size_t i = 0; i < len; i++)
+			data[i] = pattern(position + i);
+
+		// A short write is continued from where it stopped
+		size_t written = shm_ring_write(ring, data, len);
+		position += written;
+		if(written < len)
+			sched_yield();
+	}
+
+	int status;
+	assert(waitpid(pid, &status, 0) == pid);
+	assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+	shm_ring_destroy(ring);
+	assert(shm_ring_unlink(NAME));
+}
+
+// A role held by a live process is refused, a role left by a dead one is taken over
+static void takeover() {
+	shm_ring_unlink(NAME);
+	ShmRing* writer = shm_ring_create(NAME, 4096, SHM_RING_WRITER, NULL);
+	assert(writer);
+	assert(!shm_ring_peer_alive(writer));
+
+	int ready[2];
+	int quit[2];
+	assert(pipe(ready) == 0 && pipe(quit) == 0);
+
+	pid_t pid = fork();
+	assert(pid >= 0);
+	if(pid == 0) {
+		close(ready[0]);
+		close(quit[1]);
+		ShmRing* reader = shm_ring_attach(NAME, SHM_RING_READER, NULL);
+		char c = reader ? 'y' : 'n';
+		if(write(ready[1], &c, 1) != 1 || read(quit[0], &c, 1) != 1)
+			_exit(1);
+
+		// Exits without shm_ring_destroy like a crashed process
+		_exit(0);
+	}
+
+	close(ready[1]);
+	close(quit[0]);
+	char c;
+	assert(read(ready[0], &c, 1) == 1 && c == 'y');
+	assert(shm_ring_peer_alive(writer));
+	assert(!shm_ring_attach(NAME, SHM_RING_READER, NULL));
+
+	assert(write(quit[1], &c, 1) == 1);
+	int status;
+	assert(waitpid(pid, &status, 0) == pid);
+	assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+	// The reader role of the dead process is released
+	ShmRing* reader = shm_ring_attach(NAME, SHM_RING_READER, NULL);
+	assert(reader);
+	assert(shm_ring_peer_alive(writer));
+
+	assert(shm_ring_write(writer, "hello", 5) == 5);
+	char data[8];
+	assert(shm_ring_read(reader, data, sizeof(data)) == 5);
+	assert(memcmp(data, "hello", 5) == 0);
+
+	close(ready[0]);
+	close(quit[1]);
+	shm_ring_destroy(reader);
+	shm_ring_destroy(writer);
+	assert(shm_ring_unlink(NAME));
+}
+
+int main(int argc, char** argv) {
+	stream();
+	takeover();
+
+	printf("shm_ring_test: ok\n");
+	return 0;
+}
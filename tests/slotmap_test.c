@@ -0,0 +1,128 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "slotmap.h"
+#include "test.h"
+
+#define COUNT		10000
+
+// A handle of a removed element is rejected even after its slot is reused
+static void stale_handle() {
+	SlotMap* slotmap = slotmap_create(4, NULL);
+	assert(slotmap);
+
+	uint64_t old = slotmap_insert(slotmap, (void*)1);
+	assert(old);
+	assert(slotmap_remove(slotmap, old) == (void*)1);
+	assert(slotmap_is_empty(slotmap));
+
+	// The freed slot is reused with a new generation
+	uint64_t handle = slotmap_insert(slotmap, (void*)2);
+	assert(handle && handle != old);
+	assert((uint32_t)handle == (uint32_t)old);
+
+	assert(!slotmap_contains(slotmap, old));
+	assert(!slotmap_get(slotmap, old));
+	assert(!slotmap_update(slotmap, old, (void*)3));
+	assert(!slotmap_remove(slotmap, old));
+
+	assert(slotmap_get(slotmap, handle) == (void*)2);
+	assert(slotmap_size(slotmap) == 1);
+
+	// Removing twice fails the second time
+	assert(slotmap_remove(slotmap, handle) == (void*)2);
+	assert(!slotmap_remove(slotmap, handle));
+
+	// A handle of a slot never used
+	assert(!slotmap_get(slotmap, handle + 1000));
+
+	slotmap_destroy(slotmap);
+}
+
+// Iteration visits exactly the live elements, in the first slotmap_size dense positions
+static void check_dense(SlotMap* slotmap, uint64_t* handles, bool* live) {
+	size_t count = 0;
+	for(size_t i = 0; i < COUNT; i++)
+		count += live[i];
+	assert(slotmap_size(slotmap) == count);
+
+	bool* seen = calloc(COUNT, sizeof(bool));
+	SlotMapIterator iter;
+	slotmap_iterator_init(&iter, slotmap);
+	size_t visited = 0;
+	while(slotmap_iterator_has_next(&iter)) {
+		uint64_t handle;
+		uintptr_t i = (uintptr_t)slotmap_iterator_next(&iter, &handle) - 1;
+		assert(i < COUNT && live[i] && !seen[i]);
+		assert(handle == handles[i]);
+		seen[i] = true;
+		visited++;
+	}
+	assert(visited == count);
+	assert(!slotmap_iterator_next(&iter, NULL));
+	free(seen);
+}
+
+// Handles stay valid while the slots and the dense arrays grow and elements around them are removed
+static void growth_and_removal() {
+	SlotMap* slotmap = slotmap_create(1, NULL);
+	assert(slotmap);
+
+	uint64_t* handles = malloc(sizeof(uint64_t) * COUNT);
+	bool* live = calloc(COUNT, sizeof(bool));
+	for(uintptr_t i = 0; i < COUNT; i++) {
+		handles[i] = slotmap_insert(slotmap, (void*)(i + 1));
+		assert(handles[i]);
+		live[i] = true;
+	}
+	for(uintptr_t i = 0; i < COUNT; i++)
+		assert(slotmap_get(slotmap, handles[i]) == (void*)(i + 1));
+	check_dense(slotmap, handles, live);
+
+	// Random removes and reinserts keep the others reachable
+	for(int round = 0; round < COUNT * 4; round++) {
+		uintptr_t i = test_random() % COUNT;
+		if(live[i]) {
+			assert(slotmap_remove(slotmap, handles[i]) == (void*)(i + 1));
+			assert(!slotmap_contains(slotmap, handles[i]));
+			live[i] = false;
+		} else {
+			uint64_t stale = handles[i];
+			handles[i] = slotmap_insert(slotmap, (void*)(i + 1));
+			assert(handles[i] && handles[i] != stale);
+			live[i] = true;
+		}
+
+		if(round % 4000 == 0)
+			check_dense(slotmap, handles, live);
+	}
+	check_dense(slotmap, handles, live);
+
+	for(uintptr_t i = 0; i < COUNT; i++)
+		assert(slotmap_get(slotmap, handles[i]) == (live[i] ? (void*)(i + 1) : NULL));
+
+	// Removing while iterating visits the element moved into the hole
+	SlotMapIterator iter;
+	slotmap_iterator_init(&iter, slotmap);
+	while(slotmap_iterator_has_next(&iter)) {
+		uintptr_t i = (uintptr_t)slotmap_iterator_next(&iter, NULL) - 1;
+		if(i % 2) {
+			assert(slotmap_iterator_remove(&iter) == (void*)(i + 1));
+			live[i] = false;
+		}
+	}
+	check_dense(slotmap, handles, live);
+
+	free(live);
+	free(handles);
+	slotmap_destroy(slotmap);
+}
+
+int main(int argc, char** argv) {
+	stale_handle();
+	growth_and_removal();
+
+	printf("slotmap_test: ok\n");
+	return 0;
+}
@@ -0,0 +1,145 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <assert.h>
+#include "striped_map.h"
+#include "striped_set.h"
+#include "test.h"
+
+#define THREADS		4
+#define KEYS		20000
+#define ROUNDS		200000
+
+static StripedMap* map;
+static StripedSet* set;
+
+// Final state of every key, each key being owned by the thread key % THREADS
+static bool present[KEYS + 1];
+
+typedef struct {
+	uintptr_t	id;
+	uint64_t	seed;
+	size_t		won;
+} Worker;
+
+// Random put/remove of its own keys, gets of any key, all while the segments grow from one bucket
+static void* mutate(void* arg) {
+	Worker* worker = arg;
+	for(int round = 0; round < ROUNDS; round++) {
+		uintptr_t key = test_xorshift(&worker->seed) % KEYS + 1;
+		if(key % THREADS != worker->id) {
+			// Owned by another thread, data is always the key doubled if present
+			void* data = striped_map_get(map, (void*)key);
+			assert(!data || data == (void*)(key * 2));
+			continue;
+		}
+
+		if(test_xorshift(&worker->seed) % 3) {
+			assert(striped_map_put(map, (void*)key, (void*)(key * 2)) == !present[key]);
+			assert(striped_set_put(set, (void*)key) == !present[key]);
+			present[key] = true;
+		} else {
+			assert(striped_map_remove(map, (void*)key) == (present[key] ? (void*)(key * 2) : NULL));
+			assert(striped_set_remove(set, (void*)key) == (present[key] ? (void*)key : NULL));
+			present[key] = false;
+		}
+		assert(striped_map_contains(map, (void*)key) == present[key]);
+		assert(striped_set_contains(set, (void*)key) == present[key]);
+	}
+
+	return NULL;
+}
+
+static void run(void*(*fn)(void*), Worker* workers) {
+	pthread_t threads[THREADS];
+	for(uintptr_t i = 0; i < THREADS; i++) {
+		workers[i].id = i;
+		workers[i].seed = TEST_SEED + i;
+		workers[i].won = 0;
+		pthread_create(&threads[i], NULL, fn, &workers[i]);
+	}
+
+	for(int i = 0; i < THREADS; i++)
+		pthread_join(threads[i], NULL);
+}
+
+// Concurrent put/remove/get end in the state of the single threaded reference
+static void concurrent() {
+	map = striped_map_create(1, 4, NULL, NULL, NULL);
+	set = striped_set_create(1, 4, NULL, NULL, NULL);
+	assert(map && set);
+
+	Worker workers[THREADS];
+	run(mutate, workers);
+
+	size_t count = 0;
+	for(uintptr_t key = 1; key <= KEYS; key++) {
+		assert(striped_map_get(map, (void*)key) == (present[key] ? (void*)(key * 2) : NULL));
+		assert(striped_set_get(set, (void*)key) == (present[key] ? (void*)key : NULL));
+		count += present[key];
+	}
+	assert(striped_map_size(map) == count);
+	assert(striped_set_size(set) == count);
+
+	striped_map_destroy(map);
+	striped_set_destroy(set);
+}
+
+static pthread_barrier_t barrier;
+
+// Every thread puts and then removes the same keys, exactly one wins each key
+static void* race(void* arg) {
+	Worker* worker = arg;
+	for(uintptr_t key = 1; key <= KEYS; key++)
+		worker->won += striped_map_put(map, (void*)key, (void*)key);
+
+	pthread_barrier_wait(&barrier);
+	for(uintptr_t key = 1; key <= KEYS; key++)
+		worker->won += striped_map_remove(map, (void*)key) != NULL;
+
+	return NULL;
+}
+
+static void same_keys() {
+	map = striped_map_create(1, 0, NULL, NULL, NULL);
+	assert(map);
+	pthread_barrier_init(&barrier, NULL, THREADS);
+
+	Worker workers[THREADS];
+	run(race, workers);
+
+	size_t won = 0;
+	for(int i = 0; i < THREADS; i++)
+		won += workers[i].won;
+	assert(won == KEYS * 2);
+	assert(striped_map_is_empty(map));
+
+	pthread_barrier_destroy(&barrier);
+	striped_map_destroy(map);
+}
+
+// A single segment takes the path without hashing
+static void single_segment() {
+	map = striped_map_create(0, 1, NULL, NULL, NULL);
+	assert(map);
+
+	for(uintptr_t key = 1; key <= 1000; key++)
+		assert(striped_map_put(map, (void*)key, (void*)key));
+	assert(!striped_map_put(map, (void*)1, (void*)1));
+	assert(striped_map_update(map, (void*)1, (void*)2));
+	assert(striped_map_get(map, (void*)1) == (void*)2);
+	assert(!striped_map_update(map, (void*)1001, (void*)1));
+	assert(striped_map_size(map) == 1000);
+
+	striped_map_destroy(map);
+}
+
+int main(int argc, char** argv) {
+	concurrent();
+	same_keys();
+	single_segment();
+
+	printf("striped_map_test: ok\n");
+	return 0;
+}
@@ -0,0 +1,41 @@
+#ifndef __UTIL_TEST_H__
+#define __UTIL_TEST_H__
+
+#include <stdint.h>
+
+/**
+ * @file
+ * Helpers shared by the tests in tests/
+ */
+
+/**
+ * Seed of the random sequence, the same on every run so failures reproduce
+ */
+#define TEST_SEED	88172645463325252UL
+
+/**
+ * Advance a xorshift64 state which must not be zero.
+ *
+ * @param state random state
+ * @return next random number
+ */
+static inline uint64_t test_xorshift(uint64_t* state) {
+	*state ^= *state << 13;
+	*state ^= *state >> 7;
+	*state ^= *state << 17;
+
+	return *state;
+}
+
+static uint64_t test_seed = TEST_SEED;
+
+/**
+ * Get the next number of the random sequence of the test, single thread only.
+ *
+ * @return next random number
+ */
+static inline uint64_t test_random() {
+	return test_xorshift(&test_seed);
+}
+
+#endif /* __UTIL_TEST_H__ */
@@ -0,0 +1,198 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "treemap.h"
+#include "test.h"
+
+#define KEYS		5000
+#define ROUNDS		20000
+
+// Keys are 1 .. KEYS, so that 0 and KEYS + 1 are below and above every key
+static bool present[KEYS + 2];
+
+// Iteration yields exactly the present keys in ascending order
+static void check_order(TreeMap* treemap) {
+	TreeMapIterator iter;
+	treemap_iterator_init(&iter, treemap);
+
+	size_t count = 0;
+	uintptr_t last = 0;
+	for(uintptr_t key = 1; key <= KEYS; key++) {
+		if(!present[key])
+			continue;
+
+		TreeMapEntry* entry = treemap_iterator_next(&iter);
+		assert(entry);
+		assert((uintptr_t)entry->key == key);
+		assert((uintptr_t)entry->data == key * 2);
+		assert(key > last);
+		last = key;
+		count++;
+	}
+	assert(!treemap_iterator_has_next(&iter));
+	assert(!treemap_iterator_next(&iter));
+	assert(treemap_size(treemap) == count);
+}
+
+// Random puts and removes split, borrow and merge nodes, then everything is removed again
+static void random_put_remove() {
+	TreeMap* treemap = treemap_create(NULL, NULL);
+	assert(treemap);
+	memset(present, 0, sizeof(present));
+
+	for(int round = 0; round < ROUNDS; round++) {
+		uintptr_t key = test_random() % KEYS + 1;
+
+		// Grow for the first half, shrink for the second half
+		bool put = test_random() % 4 < (round < ROUNDS / 2 ? 3 : 1);
+		if(put) {
+			assert(treemap_put(treemap, (void*)key, (void*)(key * 2)) == !present[key]);
+			present[key] = true;
+		} else {
+			void* data = treemap_remove(treemap, (void*)key);
+			assert(data == (present[key] ? (void*)(key * 2) : NULL));
+			present[key] = false;
+		}
+
+		assert(treemap_contains(treemap, (void*)key) == present[key]);
+		if(round % 1000 == 0)
+			check_order(treemap);
+	}
+	check_order(treemap);
+
+	// Rebalancing all the way down to an empty root leaf
+	for(uintptr_t key = 1; key <= KEYS; key++) {
+		if(!present[key])
+			continue;
+
+		assert(treemap_remove(treemap, (void*)key) == (void*)(key * 2));
+		present[key] = false;
+		if(key % 500 == 0)
+			check_order(treemap);
+	}
+	assert(treemap_is_empty(treemap));
+	check_order(treemap);
+
+	// Still usable once empty
+	assert(treemap_put(treemap, (void*)1, (void*)2));
+	assert(treemap_get(treemap, (void*)1) == (void*)2);
+
+	treemap_destroy(treemap);
+}
+
+// Floor and ceiling at and beyond both ends, and between keys
+static void floor_ceiling() {
+	TreeMap* treemap = treemap_create(NULL, NULL);
+	assert(treemap);
+
+	TreeMapEntry entry;
+	assert(!treemap_floor(treemap, (void*)5, &entry));
+	assert(!treemap_ceiling(treemap, (void*)5, &entry));
+
+	// Even keys 2 .. KEYS
+	for(uintptr_t key = 2; key <= KEYS; key += 2)
+		assert(treemap_put(treemap, (void*)key, (void*)(key * 2)));
+
+	assert(!treemap_floor(treemap, (void*)1, &entry));
+	assert(treemap_floor(treemap, (void*)2, &entry) && (uintptr_t)entry.key == 2);
+	assert(treemap_ceiling(treemap, (void*)0, &entry) && (uintptr_t)entry.key == 2);
+	assert(treemap_ceiling(treemap, (void*)KEYS, &entry) && (uintptr_t)entry.key == KEYS);
+	assert(!treemap_ceiling(treemap, (void*)(KEYS + 1), &entry));
+	assert(treemap_floor(treemap, (void*)(KEYS + 1), &entry) && (uintptr_t)entry.key == KEYS);
+
+	for(uintptr_t key = 3; key < KEYS; key += 2) {
+		assert(treemap_floor(treemap, (void*)key, &entry));
+		assert((uintptr_t)entry.key == key - 1 && (uintptr_t)entry.data == (key - 1) * 2);
+		assert(treemap_ceiling(treemap, (void*)key, &entry));
+		assert((uintptr_t)entry.key == key + 1 && (uintptr_t)entry.data == (key + 1) * 2);
+	}
+
+	treemap_destroy(treemap);
+}
+
+// Range iteration is [from, to), including bounds outside of the keys and empty ranges
+static void range() {
+	TreeMap* treemap = treemap_create(NULL, NULL);
+	assert(treemap);
+
+	for(uintptr_t key = 10; key <= KEYS * 10; key += 10)
+		assert(treemap_put(treemap, (void*)key, (void*)key));
+
+	uintptr_t bounds[][2] = {
+		{ 0, 10 }, { 0, 11 }, { 10, 20 }, { 15, 45 }, { 20, 20 }, { 30, 20 },
+		{ 95, 1005 }, { KEYS * 10, KEYS * 10 + 1 }, { KEYS * 10 + 1, SIZE_MAX }, { 0, SIZE_MAX },
+	};
+	for(size_t i = 0; i < sizeof(bounds) / sizeof(bounds[0]); i++) {
+		uintptr_t from = bounds[i][0];
+		uintptr_t to = bounds[i][1];
+
+		TreeMapIterator iter;
+		treemap_iterator_range(&iter, treemap, (void*)from, (void*)to);
+
+		uintptr_t expected = (from + 9) / 10 * 10;
+		if(expected == 0)
+			expected = 10;
+		while(treemap_iterator_has_next(&iter)) {
+			TreeMapEntry* entry = treemap_iterator_next(&iter);
+			assert((uintptr_t)entry->key == expected);
+			expected += 10;
+		}
+
+		// Stopped at the first key not less than to, or past the last key
+		assert(expected >= to || expected > KEYS * 10);
+		assert(!treemap_iterator_next(&iter));
+	}
+
+	treemap_destroy(treemap);
+}
+
+// Separators point to the caller's keys, so removed and updated keys can be freed right away
+static void string_keys() {
+	TreeMap* treemap = treemap_create(treemap_string_compare, NULL);
+	assert(treemap);
+
+	char text[16];
+	for(int i = 0; i < 1000; i++) {
+		sprintf(text, "key%04d", i);
+		assert(treemap_put(treemap, strdup(text), NULL));
+	}
+
+	// Replacing every key with a copy frees the old pointers, which may be separators
+	for(int i = 0; i < 1000; i++) {
+		sprintf(text, "key%04d", i);
+		TreeMapEntry entry;
+		assert(treemap_ceiling(treemap, text, &entry));
+		assert(treemap_update(treemap, strdup(text), NULL));
+		free(entry.key);
+	}
+
+	// Removing every other key, then the rest
+	for(int pass = 0; pass < 2; pass++) {
+		for(int i = pass; i < 1000; i += 2) {
+			sprintf(text, "key%04d", i);
+			TreeMapEntry entry;
+			assert(treemap_ceiling(treemap, text, &entry));
+			assert(strcmp(entry.key, text) == 0);
+			treemap_remove(treemap, text);
+			free(entry.key);
+
+			// Lookups walk the separators, which must not point to freed keys
+			assert(!treemap_contains(treemap, text));
+		}
+	}
+	assert(treemap_is_empty(treemap));
+
+	treemap_destroy(treemap);
+}
+
+int main(int argc, char** argv) {
+	random_put_remove();
+	floor_ceiling();
+	range();
+	string_keys();
+
+	printf("treemap_test: ok\n");
+	return 0;
+}
@@ -0,0 +1,183 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include "tvector.h"
+
+// Adding an element of the vector itself while it grows
+static void add_own_element() {
+	TypedVector* tvector = tvector_create(sizeof(uint64_t), 4, NULL);
+	assert(tvector);
+
+	for(uint64_t i = 0; i < 4; i++)
+		assert(tvector_add(tvector, &i));
+	assert(!tvector_available(tvector));
+
+	for(int i = 0; i < 1000; i++)
+		assert(tvector_add(tvector, tvector_get(tvector, 0)));
+
+	for(size_t i = 4; i < tvector_size(tvector); i++)
+		assert(*(uint64_t*)tvector_get(tvector, i) == 0);
+
+	tvector_destroy(tvector);
+}
+
+// 12 bytes without padding, so element offsets are not a power of two and memcmp is exact
+typedef struct {
+	uint32_t	id;
+	uint32_t	value;
+	char		name[4];
+} Element;
+
+static Element element(uint32_t id) {
+	Element element = { .id = id, .value = id * 3 };
+	snprintf(element.name, sizeof(element.name), "e%u", id % 100);
+	return element;
+}
+
+// The TypedVector matches the reference, element by element
+static void check(TypedVector* tvector, Element* reference, size_t count) {
+	assert(tvector_size(tvector) == count);
+	for(size_t i = 0; i < count; i++)
+		assert(memcmp(TVECTOR_GET(tvector, Element, i), &reference[i], sizeof(Element)) == 0);
+	assert(!tvector_get(tvector, count));
+}
+
+// Whole elements are kept while the array grows from a single element
+static void growth() {
+	TypedVector* tvector = TVECTOR_CREATE(Element, 1, NULL);
+	assert(tvector && sizeof(Element) == 12);
+
+	static Element reference[1000];
+	for(uint32_t i = 0; i < 1000; i++) {
+		reference[i] = element(i);
+		if(i % 2) {
+			assert(tvector_add(tvector, &reference[i]));
+		} else {
+			Element* slot = tvector_add_slot(tvector);
+			assert(slot);
+			*slot = reference[i];
+		}
+	}
+	assert(tvector_capacity(tvector) >= 1000);
+	check(tvector, reference, 1000);
+	assert(memcmp(tvector_get_last(tvector), &reference[999], sizeof(Element)) == 0);
+
+	tvector_destroy(tvector);
+}
+
+// remove keeps the order, swap_remove moves the last element in, both copy the removed one out
+static void remove_elements() {
+	TypedVector* tvector = TVECTOR_CREATE(Element, 4, NULL);
+	assert(tvector);
+
+	static Element reference[200];
+	size_t count = 200;
+	for(uint32_t i = 0; i < count; i++) {
+		reference[i] = element(i);
+		assert(tvector_add(tvector, &reference[i]));
+	}
+
+	Element removed;
+	assert(!tvector_remove(tvector, count, &removed));
+	assert(!tvector_swap_remove(tvector, count, &removed));
+
+	// First, middle and last
+	size_t indices[] = { 0, 50, 197 };
+	for(int i = 0; i < 3; i++) {
+		size_t index = indices[i];
+		assert(tvector_remove(tvector, index, &removed));
+		assert(memcmp(&removed, &reference[index], sizeof(Element)) == 0);
+		memmove(&reference[index], &reference[index + 1], sizeof(Element) * (count - index - 1));
+		count--;
+		check(tvector, reference, count);
+	}
+
+	for(int i = 0; i < 3; i++) {
+		size_t index = indices[i] % count;
+		assert(tvector_swap_remove(tvector, index, &removed));
+		assert(memcmp(&removed, &reference[index], sizeof(Element)) == 0);
+		reference[index] = reference[--count];
+		check(tvector, reference, count);
+	}
+
+	// Swap removing the last element, and NULL element buffers
+	assert(tvector_swap_remove(tvector, count - 1, NULL));
+	count--;
+	assert(tvector_remove(tvector, 0, NULL));
+	memmove(&reference[0], &reference[1], sizeof(Element) * --count);
+	assert(tvector_remove_last(tvector, &removed));
+	assert(memcmp(&removed, &reference[--count], sizeof(Element)) == 0);
+	check(tvector, reference, count);
+
+	while(tvector_remove_last(tvector, NULL));
+	assert(tvector_is_empty(tvector));
+	assert(!tvector_remove(tvector, 0, NULL));
+	assert(!tvector_swap_remove(tvector, 0, NULL));
+	assert(!tvector_get_last(tvector));
+
+	tvector_destroy(tvector);
+}
+
+// The iterator visits every element in order, and removing while iterating skips none
+static void iterator() {
+	TypedVector* tvector = TVECTOR_CREATE(Element, 2, NULL);
+	assert(tvector);
+
+	TypedVectorIterator iter;
+	tvector_iterator_init(&iter, tvector);
+	assert(!tvector_iterator_has_next(&iter));
+	assert(!tvector_iterator_next(&iter));
+	assert(!tvector_iterator_remove(&iter, NULL));
+
+	static Element reference[300];
+	for(uint32_t i = 0; i < 300; i++) {
+		reference[i] = element(i);
+		assert(tvector_add(tvector, &reference[i]));
+	}
+
+	tvector_iterator_init(&iter, tvector);
+	for(size_t i = 0; i < 300; i++) {
+		assert(tvector_iterator_has_next(&iter));
+		assert(memcmp(tvector_iterator_next(&iter), &reference[i], sizeof(Element)) == 0);
+	}
+	assert(!tvector_iterator_has_next(&iter));
+
+	// Remove every id divisible by 3, including the first and the last
+	size_t count = 0;
+	tvector_iterator_init(&iter, tvector);
+	assert(!tvector_iterator_remove(&iter, NULL));
+	for(size_t i = 0; i < 300; i++) {
+		Element* element = tvector_iterator_next(&iter);
+		assert(element && element->id == i);
+		if(i % 3 == 0 || i == 299) {
+			Element removed;
+			assert(tvector_iterator_remove(&iter, &removed));
+			assert(removed.id == i);
+		} else {
+			reference[count++] = reference[i];
+		}
+	}
+	assert(!tvector_iterator_has_next(&iter));
+	check(tvector, reference, count);
+
+	// Remove the rest
+	tvector_iterator_init(&iter, tvector);
+	while(tvector_iterator_has_next(&iter)) {
+		tvector_iterator_next(&iter);
+		assert(tvector_iterator_remove(&iter, NULL));
+	}
+	assert(tvector_is_empty(tvector));
+
+	tvector_destroy(tvector);
+}
+
+int main(int argc, char** argv) {
+	add_own_element();
+	growth();
+	remove_elements();
+	iterator();
+
+	printf("tvector_test: ok\n");
+	return 0;
+}
@@ -0,0 +1,432 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <assert.h>
+#include "vector.h"
+#include "test.h"
+
+#define LENGTH		8
+
+// Vector of 0 .. length - 1 without spare space, so that any addition grows it
+static Vector* sequence(size_t length) {
+	Vector* vector = vector_create(length, NULL);
+	assert(vector);
+
+	for(uintptr_t i = 0; i < length; i++)
+		assert(vector_add(vector, (void*)i));
+	assert(!vector_available(vector));
+
+	return vector;
+}
+
+// Adding elements of the vector itself while it grows
+static void add_own_elements() {
+	for(size_t source = 0; source < LENGTH; source++) {
+		for(size_t count = 0; source + count <= LENGTH; count++) {
+			Vector* vector = sequence(LENGTH);
+			assert(vector_add_all(vector, &vector->array[source], count));
+
+			assert(vector_size(vector) == LENGTH + count);
+			for(size_t i = 0; i < count; i++)
+				assert(vector_get(vector, LENGTH + i) == (void*)(source + i));
+
+			vector_destroy(vector);
+		}
+	}
+}
+
+// Inserting elements of the vector itself before, across and after the index
+static void insert_own_elements() {
+	for(size_t index = 0; index <= LENGTH; index++) {
+		for(size_t source = 0; source < LENGTH; source++) {
+			for(size_t count = 0; source + count <= LENGTH; count++) {
+				void* expected[LENGTH * 2];
+				for(uintptr_t i = 0; i < index; i++)
+					expected[i] = (void*)i;
+				for(uintptr_t i = 0; i < count; i++)
+					expected[index + i] = (void*)(source + i);
+				for(uintptr_t i = index; i < LENGTH; i++)
+					expected[count + i] = (void*)i;
+
+				Vector* vector = sequence(LENGTH);
+				assert(vector_insert_at(vector, index, &vector->array[source], count));
+
+				assert(vector_size(vector) == LENGTH + count);
+				assert(memcmp(vector->array, expected, sizeof(void*) * (LENGTH + count)) == 0);
+
+				vector_destroy(vector);
+			}
+		}
+	}
+}
+
+// A count which overflows the number of elements is rejected
+static void overflow() {
+	Vector* vector = sequence(LENGTH);
+
+	assert(!vector_add_all(vector, vector->array, SIZE_MAX));
+	assert(!vector_insert_at(vector, 0, vector->array, SIZE_MAX - 1));
+	assert(!vector_insert_at(vector, LENGTH + 1, vector->array, 1));
+	assert(vector_size(vector) == LENGTH);
+
+	vector_destroy(vector);
+}
+
+static int ascending(const void* a, const void* b) {
+	uintptr_t x = *(const uintptr_t*)a;
+	uintptr_t y = *(const uintptr_t*)b;
+	return x < y ? -1 : x > y;
+}
+
+static int descending(void* a, void* b) {
+	uintptr_t x = (uintptr_t)a;
+	uintptr_t y = (uintptr_t)b;
+	return x > y ? -1 : x < y;
+}
+
+// Sizes around the parallel threshold and thread counts giving 1 to 5 runs,
+// so odd runs are carried over a merge round. The result is the input sorted.
+static void sort() {
+	static const size_t sizes[] = {
+		0, 1, 1000, VECTOR_SORT_PARALLEL_THRESHOLD - 1, VECTOR_SORT_PARALLEL_THRESHOLD,
+		VECTOR_SORT_PARALLEL_THRESHOLD + 1, VECTOR_SORT_PARALLEL_THRESHOLD * 3 / 2 + 1,
+		VECTOR_SORT_PARALLEL_THRESHOLD * 5 / 2 + 7,
+	};
+	static const size_t threads[] = { 1, 2, 3, 0, 5 };
+
+	for(size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+		size_t size = sizes[s];
+		uintptr_t* expected = malloc(sizeof(uintptr_t) * (size + 1));
+		for(size_t i = 0; i < size; i++)
+			expected[i] = test_random() % (size + 1);	// with duplicates
+		qsort(expected, size, sizeof(uintptr_t), ascending);
+
+		for(size_t t = 0; t < sizeof(threads) / sizeof(threads[0]); t++) {
+			for(int order = 0; order < 2; order++) {
+				Vector* vector = vector_create(size + 1, NULL);
+				assert(vector);
+				for(size_t i = 0; i < size; i++)
+					assert(vector_add(vector, (void*)expected[i]));
+
+				// Shuffled, so the input is a permutation of expected
+				for(size_t i = size; i > 1; i--) {
+					size_t j = test_random() % i;
+					void* swap = vector->array[i - 1];
+					vector->array[i - 1] = vector->array[j];
+					vector->array[j] = swap;
+				}
+
+				vector_sort(vector, order ? descending : NULL, threads[t]);
+
+				assert(vector_size(vector) == size);
+				for(size_t i = 0; i < size; i++)
+					assert((uintptr_t)vector_get(vector, i) == expected[order ? size - 1 - i : i]);
+
+				vector_destroy(vector);
+			}
+		}
+		free(expected);
+	}
+}
+
+static bool equals(void* v1, void* v2) {
+	return v1 == v2;
+}
+
+// The target at every position of lengths 0 to 40 covers the vector rounds and the scalar tail
+static void index_of() {
+	for(int sse2 = 0; sse2 < 2; sse2++) {
+		vector_force_sse2(sse2);
+
+		for(size_t length = 0; length <= 40; length++) {
+			Vector* vector = sequence(length);
+			void* missing = (void*)(uintptr_t)length;
+			assert(vector_index_of(vector, missing, NULL) == (size_t)-1);
+			assert(vector_index_of(vector, missing, equals) == (size_t)-1);
+
+			for(size_t position = 0; position < length; position++) {
+				// A second match after the target, and a decoy before it whose lower 32 bits are equal
+				void* target = (void*)(0x100000000UL | position);
+				vector->array[position] = target;
+				if(position + 1 < length)
+					vector->array[position + 1] = target;
+				if(position > 0)
+					vector->array[position - 1] = (void*)(uintptr_t)position;
+
+				assert(vector_index_of(vector, target, NULL) == position);
+				assert(vector_index_of(vector, target, equals) == position);
+				assert(vector_index_of(vector, (void*)(0x100000000UL | length), NULL) == (size_t)-1);
+				assert(vector_index_of(vector, (void*)(uintptr_t)position, NULL) == (position > 0 ? position - 1 : (size_t)-1));
+
+				vector->array[position] = (void*)(uintptr_t)position;
+				if(position > 0)
+					vector->array[position - 1] = (void*)(uintptr_t)(position - 1);
+				if(position + 1 < length)
+					vector->array[position + 1] = (void*)(uintptr_t)(position + 1);
+			}
+
+			vector_destroy(vector);
+		}
+	}
+	vector_force_sse2(false);
+}
+
+// Reserve never shrinks, resize grows with NULL slots and shrinks the size only
+static void reserve_resize() {
+	Vector* vector = vector_create(4, NULL);
+	assert(vector);
+
+	assert(vector_reserve(vector, 100));
+	assert(vector_capacity(vector) == 100 && vector_is_empty(vector));
+	assert(vector_reserve(vector, 10));
+	assert(vector_capacity(vector) == 100);
+
+	for(uintptr_t i = 1; i <= 50; i++)
+		assert(vector_add(vector, (void*)i));
+
+	// Shrinking keeps the capacity and the leading elements
+	assert(vector_resize(vector, 20));
+	assert(vector_size(vector) == 20 && vector_capacity(vector) == 100);
+	for(uintptr_t i = 1; i <= 20; i++)
+		assert(vector_get(vector, i - 1) == (void*)i);
+
+	// Growing again clears the slots dropped by the shrink
+	assert(vector_resize(vector, 60));
+	assert(vector_size(vector) == 60);
+	for(size_t i = 20; i < 60; i++)
+		assert(vector_get(vector, i) == NULL);
+
+	// Growing past the capacity
+	assert(vector_resize(vector, 500));
+	assert(vector_size(vector) == 500 && vector_capacity(vector) >= 500);
+	for(uintptr_t i = 1; i <= 20; i++)
+		assert(vector_get(vector, i - 1) == (void*)i);
+	for(size_t i = 20; i < 500; i++)
+		assert(vector_get(vector, i) == NULL);
+
+	assert(vector_resize(vector, 0));
+	assert(vector_is_empty(vector));
+
+	// An empty Vector packs and grows again
+	assert(vector_pack(vector));
+	assert(vector_add(vector, (void*)1));
+	assert(vector_get(vector, 0) == (void*)1);
+
+	vector_destroy(vector);
+}
+
+static size_t growth_calls;
+
+// Grows by exactly 3 slots past the required size
+static size_t growth_three(size_t size, size_t required) {
+	growth_calls++;
+	return required + 3;
+}
+
+static void growth() {
+	Vector* vector = vector_create(2, NULL);
+	assert(vector);
+	vector_set_growth(vector, growth_three);
+
+	for(uintptr_t i = 1; i <= 100; i++) {
+		assert(vector_add(vector, (void*)i));
+		assert(vector_capacity(vector) == (i <= 2 ? 2 : 2 + (i + 1) / 4 * 4));
+	}
+	assert(growth_calls == 25);
+
+	// Back to the default
+	vector_set_growth(vector, NULL);
+	assert(vector_resize(vector, vector_capacity(vector) + 1));
+	assert(vector_capacity(vector) == vector_growth_default(102, 103));
+	assert(growth_calls == 25);
+
+	for(uintptr_t i = 1; i <= 100; i++)
+		assert(vector_get(vector, i - 1) == (void*)i);
+	vector_destroy(vector);
+
+	assert(vector_growth_default(0, 1) == 1);
+	assert(vector_growth_default(10, 11) == 16);
+	assert(vector_growth_default(10, 100) == 100);
+	assert(vector_growth_double(0, 1) == 1);
+	assert(vector_growth_double(10, 11) == 20);
+	assert(vector_growth_double(10, 100) == 100);
+}
+
+// Growing across VECTOR_MREMAP_THRESHOLD moves the array to mmap, packing keeps it there
+static void mapped() {
+	size_t count = VECTOR_MREMAP_THRESHOLD / sizeof(void*) * 3;
+
+	Vector* vector = vector_create(16, NULL);
+	assert(vector);
+	for(uintptr_t i = 0; i < count; i++) {
+		assert(vector_add(vector, (void*)(i * 7)));
+		assert(vector->mapped == (vector_capacity(vector) * sizeof(void*) >= VECTOR_MREMAP_THRESHOLD));
+	}
+	assert(vector->mapped);
+
+	while(vector_size(vector) > count / 5)
+		vector_remove_last(vector);
+	assert(vector_pack(vector));
+	assert(vector->mapped && vector_capacity(vector) >= count / 5);
+	assert(vector_capacity(vector) * sizeof(void*) < (count / 5) * sizeof(void*) + sysconf(_SC_PAGESIZE));
+	for(uintptr_t i = 0; i < count / 5; i++)
+		assert(vector_get(vector, i) == (void*)(i * 7));
+
+	// Grows by remapping after the pack
+	for(uintptr_t i = count / 5; i < count; i++)
+		assert(vector_add(vector, (void*)(i * 7)));
+	for(uintptr_t i = 0; i < count; i++)
+		assert(vector_get(vector, i) == (void*)(i * 7));
+
+	// An empty mapped Vector packs to a page
+	assert(vector_resize(vector, 0));
+	assert(vector_pack(vector));
+	assert(vector->mapped && vector_capacity(vector) * sizeof(void*) == (size_t)sysconf(_SC_PAGESIZE));
+	assert(vector_add(vector, (void*)1));
+
+	vector_destroy(vector);
+}
+
+// Element i of SmallVector tests
+#define ELEMENT(i)	((void*)(uintptr_t)((i) * 3 + 1))
+
+static void check_elements(Vector* vector, size_t count) {
+	assert(vector_size(vector) == count);
+	for(size_t i = 0; i < count; i++)
+		assert(vector_get(vector, i) == ELEMENT(i));
+}
+
+// Inline up to VECTOR_INLINE_SIZE, then on the heap with the contents kept
+static void small_spill() {
+	SMALL_VECTOR(vector);
+	for(size_t i = 0; i < VECTOR_INLINE_SIZE; i++)
+		assert(vector_add(vector, ELEMENT(i)));
+	assert(vector->array == vector_storage.inline_array);
+	assert(vector->embedded && !vector_available(vector));
+
+	assert(vector_add(vector, ELEMENT(VECTOR_INLINE_SIZE)));
+	assert(vector->array != vector_storage.inline_array);
+	assert(!vector->embedded);
+	check_elements(vector, VECTOR_INLINE_SIZE + 1);
+
+	for(size_t i = VECTOR_INLINE_SIZE + 1; i < 100; i++)
+		assert(vector_add(vector, ELEMENT(i)));
+	check_elements(vector, 100);
+
+	// Reused after fini, inline again
+	small_vector_fini(vector);
+	assert(vector_is_empty(vector));
+	assert(vector->array == vector_storage.inline_array && vector->embedded);
+	for(size_t i = 0; i < 20; i++)
+		assert(vector_add(vector, ELEMENT(i)));
+	check_elements(vector, 20);
+	small_vector_fini(vector);
+
+	// fini of a vector which never spilled
+	assert(vector_add(vector, ELEMENT(0)));
+	small_vector_fini(vector);
+	assert(vector_is_empty(vector) && vector->embedded);
+	small_vector_fini(vector);
+}
+
+// vector_pack keeps an inline array and shrinks a spilled one
+static void small_pack() {
+	SMALL_VECTOR(vector);
+	for(size_t i = 0; i < 3; i++)
+		assert(vector_add(vector, ELEMENT(i)));
+	assert(vector_pack(vector));
+	assert(vector->array == vector_storage.inline_array && vector->embedded);
+	check_elements(vector, 3);
+
+	for(size_t i = 3; i < 40; i++)
+		assert(vector_add(vector, ELEMENT(i)));
+	while(vector_size(vector) > 5)
+		vector_remove_last(vector);
+	assert(vector_pack(vector));
+	assert(vector_capacity(vector) == 5 && !vector->embedded);
+	check_elements(vector, 5);
+
+	// Growing again after packing
+	for(size_t i = 5; i < 50; i++)
+		assert(vector_add(vector, ELEMENT(i)));
+	check_elements(vector, 50);
+	small_vector_fini(vector);
+}
+
+// A SmallVector of a single allocation is freed by vector_destroy, inline or spilled
+static void small_create() {
+	Vector* vector = small_vector_create(NULL);
+	assert(vector && vector->embedded);
+	for(size_t i = 0; i < VECTOR_INLINE_SIZE; i++)
+		assert(vector_add(vector, ELEMENT(i)));
+	check_elements(vector, VECTOR_INLINE_SIZE);
+	vector_destroy(vector);
+
+	vector = small_vector_create(NULL);
+	assert(vector);
+	assert(vector_reserve(vector, 1000));
+	assert(!vector->embedded && vector_capacity(vector) >= 1000);
+	for(size_t i = 0; i < 1000; i++)
+		assert(vector_add(vector, ELEMENT(i)));
+	check_elements(vector, 1000);
+	vector_destroy(vector);
+}
+
+// Spilling from the inline array straight to mmap, and back to inline with fini
+static void small_mapped() {
+	size_t count = VECTOR_MREMAP_THRESHOLD / sizeof(void*) + 100;
+
+	for(int created = 0; created < 2; created++) {
+		SmallVector storage;
+		Vector* vector = created ? small_vector_create(NULL) : small_vector_init(&storage);
+		assert(vector);
+
+		for(int round = 0; round < 2; round++) {
+			for(size_t i = 0; i < 4; i++)
+				assert(vector_add(vector, ELEMENT(i)));
+			assert(vector->embedded && !vector->mapped);
+
+			// The inline elements are copied, and the inline array is not freed
+			assert(vector_reserve(vector, count));
+			assert(vector->mapped && !vector->embedded);
+			check_elements(vector, 4);
+
+			for(size_t i = 4; i < count; i++)
+				assert(vector_add(vector, ELEMENT(i)));
+			check_elements(vector, count);
+
+			// Packing a mapped array below the threshold keeps it mapped
+			while(vector_size(vector) > 10)
+				vector_remove_last(vector);
+			assert(vector_pack(vector));
+			assert(vector->mapped);
+			check_elements(vector, 10);
+
+			small_vector_fini(vector);
+			assert(vector->embedded && !vector->mapped && vector_is_empty(vector));
+		}
+
+		if(created)
+			vector_destroy(vector);
+	}
+}
+
+int main(int argc, char** argv) {
+	add_own_elements();
+	insert_own_elements();
+	overflow();
+	sort();
+	index_of();
+	reserve_resize();
+	growth();
+	mapped();
+	small_spill();
+	small_pack();
+	small_create();
+	small_mapped();
+
+	printf("vector_test: ok\n");
+	return 0;
+}
@@ -0,0 +1,88 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <assert.h>
+#include "wsdeque.h"
+
+#define THIEVES		3
+#define COUNT		200000
+
+static WSDeque* deque;
+static uint32_t taken[COUNT + 1];
+static volatile bool done;
+
+static void take(void* data) {
+	assert(data);
+	assert((uintptr_t)data <= COUNT);
+	__atomic_fetch_add(&taken[(uintptr_t)data], 1, __ATOMIC_RELAXED);
+}
+
+static void* steal(void* arg) {
+	while(!__atomic_load_n(&done, __ATOMIC_ACQUIRE) || !wsdeque_empty(deque)) {
+		void* data = wsdeque_steal(deque);
+		if(data)
+			take(data);
+	}
+
+	return NULL;
+}
+
+// The owner pushes and pops while thieves steal, every element is taken once
+static void push_pop_steal() {
+	deque = wsdeque_create(4, NULL);
+	assert(deque);
+
+	pthread_t thieves[THIEVES];
+	for(int i = 0; i < THIEVES; i++)
+		pthread_create(&thieves[i], NULL, steal, NULL);
+
+	// Bursts of pushes grow the array while thieves read it
+	uintptr_t next = 1;
+	while(next <= COUNT) {
+		for(int i = 0; i < 64 && next <= COUNT; i++)
+			assert(wsdeque_push(deque, (void*)next++));
+
+		for(int i = 0; i < 16; i++) {
+			void* data = wsdeque_pop(deque);
+			if(data)
+				take(data);
+		}
+	}
+
+	void* data;
+	while((data = wsdeque_pop(deque)))
+		take(data);
+	__atomic_store_n(&done, true, __ATOMIC_RELEASE);
+
+	for(int i = 0; i < THIEVES; i++)
+		pthread_join(thieves[i], NULL);
+
+	for(int i = 1; i <= COUNT; i++)
+		assert(taken[i] == 1);
+	assert(wsdeque_empty(deque));
+
+	wsdeque_destroy(deque);
+}
+
+// Pop is LIFO and steal is FIFO on a single thread
+static void order() {
+	WSDeque embedded;
+	assert(wsdeque_init(&embedded, 2));
+
+	for(uintptr_t i = 1; i <= 100; i++)
+		assert(wsdeque_push(&embedded, (void*)i));
+	assert(wsdeque_size(&embedded) == 100);
+	assert(wsdeque_steal(&embedded) == (void*)1);
+	assert(wsdeque_pop(&embedded) == (void*)100);
+	assert(wsdeque_size(&embedded) == 98);
+
+	wsdeque_fini(&embedded);
+}
+
+int main(int argc, char** argv) {
+	push_pop_steal();
+	order();
+
+	printf("wsdeque_test: ok\n");
+	return 0;
+}
@@ -0,0 +1,512 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "treemap.h"
+
+#if TREEMAP_FANOUT < 4
+#error "TREEMAP_FANOUT must be at least 4"
+#endif
+
+// Every node except the root keeps at least this many keys
+#define MIN_KEYS		((TREEMAP_FANOUT - 1) / 2)
+
+#define LEAF(node)		((TreeMapLeaf*)(node))
+#define BRANCH(node)		((TreeMapBranch*)(node))
+
+static void* node_alloc(size_t size) {
+	void* node;
+	if(posix_memalign(&node, 64, size) != 0)
+		return NULL;
+
+	return node;
+}
+
+static TreeMapLeaf* leaf_create() {
+	TreeMapLeaf* leaf = node_alloc(sizeof(TreeMapLeaf));
+	if(!leaf)
+		return NULL;
+
+	leaf->node.count = 0;
+	leaf->node.leaf = true;
+	leaf->prev = NULL;
+	leaf->next = NULL;
+
+	return leaf;
+}
+
+static TreeMapBranch* branch_create() {
+	TreeMapBranch* branch = node_alloc(sizeof(TreeMapBranch));
+	if(!branch)
+		return NULL;
+
+	branch->node.count = 0;
+	branch->node.leaf = false;
+
+	return branch;
+}
+
+static void node_destroy(TreeMapNode* node) {
+	if(!node->leaf) {
+		for(size_t i = 0; i <= node->count; i++)
+			node_destroy(BRANCH(node)->children[i]);
+	}
+
+	free(node);
+}
+
+// First index whose key is not less than the key
+static size_t lower_bound(TreeMap* treemap, TreeMapNode* node, void* key) {
+	size_t low = 0;
+	size_t high = node->count;
+	if(treemap->compare == treemap_uint64_compare) {
+		// Integer keys are compared inline instead of calling through the pointer
+		while(low < high) {
+			size_t mid = (low + high) / 2;
+			if((uintptr_t)node->keys[mid] < (uintptr_t)key)
+				low = mid + 1;
+			else
+				high = mid;
+		}
+
+		return low;
+	}
+
+	while(low < high) {
+		size_t mid = (low + high) / 2;
+		if(treemap->compare(node->keys[mid], key) < 0)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	return low;
+}
+
+// First index whose key is greater than the key
+static size_t upper_bound(TreeMap* treemap, TreeMapNode* node, void* key) {
+	size_t low = 0;
+	size_t high = node->count;
+	if(treemap->compare == treemap_uint64_compare) {
+		while(low < high) {
+			size_t mid = (low + high) / 2;
+			if((uintptr_t)node->keys[mid] <= (uintptr_t)key)
+				low = mid + 1;
+			else
+				high = mid;
+		}
+
+		return low;
+	}
+
+	while(low < high) {
+		size_t mid = (low + high) / 2;
+		if(treemap->compare(node->keys[mid], key) <= 0)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	return low;
+}
+
+static TreeMapLeaf* find_leaf(TreeMap* treemap, void* key) {
+	TreeMapNode* node = treemap->root;
+	while(!node->leaf)
+		node = BRANCH(node)->children[upper_bound(treemap, node, key)];
+
+	return LEAF(node);
+}
+
+static void** find(TreeMap* treemap, void* key) {
+	TreeMapLeaf* leaf = find_leaf(treemap, key);
+	size_t index = lower_bound(treemap, &leaf->node, key);
+	if(index < leaf->node.count && treemap->compare(leaf->node.keys[index], key) == 0)
+		return &leaf->datas[index];
+
+	return NULL;
+}
+
+// Split the full child in half and put the new right sibling next to it
+static bool split_child(TreeMapBranch* branch, size_t index) {
+	TreeMapNode* child = branch->children[index];
+	size_t half = TREEMAP_FANOUT / 2;
+	TreeMapNode* sibling;
+	void* separator;
+
+	if(child->leaf) {
+		TreeMapLeaf* left = LEAF(child);
+		TreeMapLeaf* right = leaf_create();
+		if(!right)
+			return false;
+
+		right->node.count = TREEMAP_FANOUT - half;
+		memcpy(right->node.keys, child->keys + half, sizeof(void*) * right->node.count);
+		memcpy(right->datas, left->datas + half, sizeof(void*) * right->node.count);
+
+		right->prev = left;
+		right->next = left->next;
+		if(left->next)
+			left->next->prev = right;
+		left->next = right;
+
+		separator = right->node.keys[0];
+		sibling = &right->node;
+	} else {
+		TreeMapBranch* left = BRANCH(child);
+		TreeMapBranch* right = branch_create();
+		if(!right)
+			return false;
+
+		// The middle key moves up to the parent
+		right->node.count = TREEMAP_FANOUT - half - 1;
+		memcpy(right->node.keys, child->keys + half + 1, sizeof(void*) * right->node.count);
+		memcpy(right->children, left->children + half + 1, sizeof(TreeMapNode*) * (right->node.count + 1));
+
+		separator = child->keys[half];
+		sibling = &right->node;
+	}
+	child->count = half;
+
+	TreeMapNode* node = &branch->node;
+	memmove(node->keys + index + 1, node->keys + index, sizeof(void*) * (node->count - index));
+	memmove(branch->children + index + 2, branch->children + index + 1, sizeof(TreeMapNode*) * (node->count - index));
+	node->keys[index] = separator;
+	branch->children[index + 1] = sibling;
+	node->count++;
+
+	return true;
+}
+
+static void borrow_left(TreeMapBranch* branch, size_t index) {
+	TreeMapNode* left = branch->children[index - 1];
+	TreeMapNode* child = branch->children[index];
+
+	memmove(child->keys + 1, child->keys, sizeof(void*) * child->count);
+	if(child->leaf) {
+		memmove(LEAF(child)->datas + 1, LEAF(child)->datas, sizeof(void*) * child->count);
+		child->keys[0] = left->keys[left->count - 1];
+		LEAF(child)->datas[0] = LEAF(left)->datas[left->count - 1];
+		branch->node.keys[index - 1] = child->keys[0];
+	} else {
+		memmove(BRANCH(child)->children + 1, BRANCH(child)->children, sizeof(TreeMapNode*) * (child->count + 1));
+		child->keys[0] = branch->node.keys[index - 1];
+		BRANCH(child)->children[0] = BRANCH(left)->children[left->count];
+		branch->node.keys[index - 1] = left->keys[left->count - 1];
+	}
+
+	left->count--;
+	child->count++;
+}
+
+static void borrow_right(TreeMapBranch* branch, size_t index) {
+	TreeMapNode* child = branch->children[index];
+	TreeMapNode* right = branch->children[index + 1];
+
+	if(child->leaf) {
+		child->keys[child->count] = right->keys[0];
+		LEAF(child)->datas[child->count] = LEAF(right)->datas[0];
+		memmove(LEAF(right)->datas, LEAF(right)->datas + 1, sizeof(void*) * (right->count - 1));
+		memmove(right->keys, right->keys + 1, sizeof(void*) * (right->count - 1));
+		branch->node.keys[index] = right->keys[0];
+	} else {
+		child->keys[child->count] = branch->node.keys[index];
+		BRANCH(child)->children[child->count + 1] = BRANCH(right)->children[0];
+		branch->node.keys[index] = right->keys[0];
+		memmove(right->keys, right->keys + 1, sizeof(void*) * (right->count - 1));
+		memmove(BRANCH(right)->children, BRANCH(right)->children + 1, sizeof(TreeMapNode*) * right->count);
+	}
+
+	right->count--;
+	child->count++;
+}
+
+// Merge the right sibling into the child at the index and drop the separator between them
+static void merge(TreeMapBranch* branch, size_t index) {
+	TreeMapNode* left = branch->children[index];
+	TreeMapNode* right = branch->children[index + 1];
+
+	if(left->leaf) {
+		memcpy(left->keys + left->count, right->keys, sizeof(void*) * right->count);
+		memcpy(LEAF(left)->datas + left->count, LEAF(right)->datas, sizeof(void*) * right->count);
+		left->count += right->count;
+
+		LEAF(left)->next = LEAF(right)->next;
+		if(LEAF(right)->next)
+			LEAF(right)->next->prev = LEAF(left);
+	} else {
+		left->keys[left->count] = branch->node.keys[index];
+		memcpy(left->keys + left->count + 1, right->keys, sizeof(void*) * right->count);
+		memcpy(BRANCH(left)->children + left->count + 1, BRANCH(right)->children, sizeof(TreeMapNode*) * (right->count + 1));
+		left->count += right->count + 1;
+	}
+	free(right);
+
+	TreeMapNode* node = &branch->node;
+	memmove(node->keys + index, node->keys + index + 1, sizeof(void*) * (node->count - index - 1));
+	memmove(branch->children + index + 1, branch->children + index + 2, sizeof(TreeMapNode*) * (node->count - index - 1));
+	node->count--;
+}
+
+static void rebalance(TreeMapBranch* branch, size_t index) {
+	if(index > 0 && branch->children[index - 1]->count > MIN_KEYS)
+		borrow_left(branch, index);
+	else if(index < branch->node.count && branch->children[index + 1]->count > MIN_KEYS)
+		borrow_right(branch, index);
+	else if(index > 0)
+		merge(branch, index - 1);
+	else
+		merge(branch, index);
+}
+
+// Separators are the caller's key pointers, so the one equal to the key is
+// replaced when the key leaves the leaves, by the smallest key right of it if
+// replacement is NULL
+static void replace_separator(TreeMap* treemap, void* key, void* replacement) {
+	TreeMapNode* node = treemap->root;
+	while(!node->leaf) {
+		size_t index = upper_bound(treemap, node, key);
+		if(index > 0 && treemap->compare(node->keys[index - 1], key) == 0) {
+			if(replacement) {
+				node->keys[index - 1] = replacement;
+			} else {
+				TreeMapNode* min = BRANCH(node)->children[index];
+				while(!min->leaf)
+					min = BRANCH(min)->children[0];
+
+				node->keys[index - 1] = min->keys[0];
+			}
+		}
+		node = BRANCH(node)->children[index];
+	}
+}
+
+static bool remove_key(TreeMap* treemap, TreeMapNode* node, void* key, void** data) {
+	if(node->leaf) {
+		size_t index = lower_bound(treemap, node, key);
+		if(index >= node->count || treemap->compare(node->keys[index], key) != 0)
+			return false;
+
+		*data = LEAF(node)->datas[index];
+		node->count--;
+		memmove(node->keys + index, node->keys + index + 1, sizeof(void*) * (node->count - index));
+		memmove(LEAF(node)->datas + index, LEAF(node)->datas + index + 1, sizeof(void*) * (node->count - index));
+		return true;
+	}
+
+	size_t index = upper_bound(treemap, node, key);
+	if(!remove_key(treemap, BRANCH(node)->children[index], key, data))
+		return false;
+
+	if(BRANCH(node)->children[index]->count < MIN_KEYS)
+		rebalance(BRANCH(node), index);
+
+	return true;
+}
+
+TreeMap* treemap_create(int(*compare)(void*,void*), void* pool) {
+	TreeMap* treemap = malloc(sizeof(TreeMap));
+	if(!treemap)
+		return NULL;
+
+	TreeMapLeaf* root = leaf_create();
+	if(!root) {
+		free(treemap);
+		return NULL;
+	}
+
+	treemap->root = &root->node;
+	treemap->size = 0;
+	treemap->compare = compare ? compare : treemap_uint64_compare;
+	treemap->pool = pool;
+
+	return treemap;
+}
+
+void treemap_destroy(TreeMap* treemap) {
+	node_destroy(treemap->root);
+	free(treemap);
+}
+
+bool treemap_is_empty(TreeMap* treemap) {
+	return treemap->size == 0;
+}
+
+// Full nodes are split on the way down, so a split never has to go back up
+bool treemap_put(TreeMap* treemap, void* key, void* data) {
+	if(treemap->root->count == TREEMAP_FANOUT) {
+		TreeMapBranch* root = branch_create();
+		if(!root)
+			return false;
+
+		root->children[0] = treemap->root;
+		if(!split_child(root, 0)) {
+			free(root);
+			return false;
+		}
+		treemap->root = &root->node;
+	}
+
+	TreeMapNode* node = treemap->root;
+	while(!node->leaf) {
+		TreeMapBranch* branch = BRANCH(node);
+		size_t index = upper_bound(treemap, node, key);
+		if(branch->children[index]->count == TREEMAP_FANOUT) {
+			if(!split_child(branch, index))
+				return false;
+
+			if(treemap->compare(node->keys[index], key) <= 0)
+				index++;
+		}
+		node = branch->children[index];
+	}
+
+	size_t index = lower_bound(treemap, node, key);
+	if(index < node->count && treemap->compare(node->keys[index], key) == 0)
+		return false;
+
+	TreeMapLeaf* leaf = LEAF(node);
+	memmove(node->keys + index + 1, node->keys + index, sizeof(void*) * (node->count - index));
+	memmove(leaf->datas + index + 1, leaf->datas + index, sizeof(void*) * (node->count - index));
+	node->keys[index] = key;
+	leaf->datas[index] = data;
+	node->count++;
+	treemap->size++;
+
+	return true;
+}
+
+bool treemap_update(TreeMap* treemap, void* key, void* data) {
+	TreeMapLeaf* leaf = find_leaf(treemap, key);
+	size_t index = lower_bound(treemap, &leaf->node, key);
+	if(index >= leaf->node.count || treemap->compare(leaf->node.keys[index], key) != 0)
+		return false;
+
+	leaf->node.keys[index] = key;
+	leaf->datas[index] = data;
+	replace_separator(treemap, key, key);
+	return true;
+}
+
+void* treemap_get(TreeMap* treemap, void* key) {
+	void** slot = find(treemap, key);
+	return slot ? *slot : NULL;
+}
+
+bool treemap_contains(TreeMap* treemap, void* key) {
+	return find(treemap, key) != NULL;
+}
+
+void* treemap_remove(TreeMap* treemap, void* key) {
+	void* data;
+	if(!remove_key(treemap, treemap->root, key, &data))
+		return NULL;
+
+	TreeMapNode* root = treemap->root;
+	if(!root->leaf && root->count == 0) {
+		treemap->root = BRANCH(root)->children[0];
+		free(root);
+	}
+	replace_separator(treemap, key, NULL);
+	treemap->size--;
+
+	return data;
+}
+
+bool treemap_floor(TreeMap* treemap, void* key, TreeMapEntry* entry) {
+	TreeMapLeaf* leaf = find_leaf(treemap, key);
+	size_t index = upper_bound(treemap, &leaf->node, key);
+	if(index == 0) {
+		leaf = leaf->prev;
+		if(!leaf)
+			return false;
+
+		index = leaf->node.count;
+	}
+
+	entry->key = leaf->node.keys[index - 1];
+	entry->data = leaf->datas[index - 1];
+	return true;
+}
+
+bool treemap_ceiling(TreeMap* treemap, void* key, TreeMapEntry* entry) {
+	TreeMapLeaf* leaf = find_leaf(treemap, key);
+	size_t index = lower_bound(treemap, &leaf->node, key);
+	if(index == leaf->node.count) {
+		leaf = leaf->next;
+		if(!leaf)
+			return false;
+
+		index = 0;
+	}
+
+	entry->key = leaf->node.keys[index];
+	entry->data = leaf->datas[index];
+	return true;
+}
+
+size_t treemap_size(TreeMap* treemap) {
+	return treemap->size;
+}
+
+void treemap_iterator_init(TreeMapIterator* iter, TreeMap* treemap) {
+	TreeMapNode* node = treemap->root;
+	while(!node->leaf)
+		node = BRANCH(node)->children[0];
+
+	iter->treemap = treemap;
+	iter->leaf = LEAF(node);
+	iter->index = 0;
+	iter->to = NULL;
+	iter->bounded = false;
+}
+
+void treemap_iterator_lower_bound(TreeMapIterator* iter, TreeMap* treemap, void* key) {
+	iter->treemap = treemap;
+	iter->leaf = find_leaf(treemap, key);
+	iter->index = lower_bound(treemap, &iter->leaf->node, key);
+	iter->to = NULL;
+	iter->bounded = false;
+}
+
+void treemap_iterator_range(TreeMapIterator* iter, TreeMap* treemap, void* from, void* to) {
+	treemap_iterator_lower_bound(iter, treemap, from);
+	iter->to = to;
+	iter->bounded = true;
+}
+
+bool treemap_iterator_has_next(TreeMapIterator* iter) {
+	while(iter->leaf && iter->index >= iter->leaf->node.count) {
+		iter->leaf = iter->leaf->next;
+		iter->index = 0;
+	}
+
+	if(!iter->leaf)
+		return false;
+
+	if(iter->bounded && iter->treemap->compare(iter->leaf->node.keys[iter->index], iter->to) >= 0)
+		return false;
+
+	return true;
+}
+
+TreeMapEntry* treemap_iterator_next(TreeMapIterator* iter) {
+	if(!treemap_iterator_has_next(iter))
+		return NULL;
+
+	iter->entry.key = iter->leaf->node.keys[iter->index];
+	iter->entry.data = iter->leaf->datas[iter->index];
+	iter->index++;
+
+	return &iter->entry;
+}
+
+int treemap_uint64_compare(void* key1, void* key2) {
+	uintptr_t k1 = (uintptr_t)key1;
+	uintptr_t k2 = (uintptr_t)key2;
+
+	return (k1 > k2) - (k1 < k2);
+}
+
+int treemap_string_compare(void* key1, void* key2) {
+	return strcmp((const char*)key1, (const char*)key2);
+}
@@ -0,0 +1,254 @@
+#ifndef __UTIL_TREEMAP_H__
+#define __UTIL_TREEMAP_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @file
+ * Ordered Map data structure (B+tree)
+ *
+ * Keys are kept sorted by a comparing function. Elements are stored in leaf
+ * nodes which are linked to each other, so ordered and range iteration walk
+ * the leaves without going back to the root. Keys are not copied, and a key
+ * can be freed once it is removed or replaced by treemap_update.
+ */
+
+/**
+ * Maximum number of keys of a node. 15 keys and the 8 byte count and leaf
+ * header fill 128 bytes, and nodes are aligned to a cache line, so a key
+ * search touches exactly the two cache lines of a node.
+ */
+#ifndef TREEMAP_FANOUT
+#define TREEMAP_FANOUT		15
+#endif
+
+/**
+ * Tree map node header (internal use only)
+ */
+typedef struct _TreeMapNode {
+	uint32_t	count;				///< Number of keys
+	bool		leaf;				///< Node is a leaf
+	void*		keys[TREEMAP_FANOUT];		///< Sorted keys
+} __attribute__((aligned(64))) TreeMapNode;
+
+/**
+ * Tree map leaf node (internal use only)
+ */
+typedef struct _TreeMapLeaf {
+	TreeMapNode	node;				///< Node header
+	void*		datas[TREEMAP_FANOUT];		///< Values of the keys
+	struct _TreeMapLeaf*	prev;			///< Previous leaf
+	struct _TreeMapLeaf*	next;			///< Next leaf
+} TreeMapLeaf;
+
+/**
+ * Tree map branch node (internal use only)
+ */
+typedef struct _TreeMapBranch {
+	TreeMapNode	node;				///< Node header
+	TreeMapNode*	children[TREEMAP_FANOUT + 1];	///< Children, keys of children[i + 1] are not less than keys[i]
+} TreeMapBranch;
+
+/**
+ * Tree map entry data structure
+ */
+typedef struct _TreeMapEntry {
+	void*	key;			///< Key
+	void*	data;			///< Value
+} TreeMapEntry;
+
+/**
+ * Ordered Map data structure
+ */
+typedef struct _TreeMap {
+	TreeMapNode*	root;		///< Root node (internal use only)
+	size_t		size;		///< Number of elements (internal use only)
+
+	int(*compare)(void*,void*);	///< comparing function
+
+	void*		pool;		///< Memory pool (internal use only)
+} TreeMap;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Create a TreeMap.
+ *
+ * @param compare key comparing function returning negative, zero or positive value, if compare is NULL treemap_uint64_compare will be used
+ * @param pool memory pool to use, if NULL local memory area will be used
+ */
+TreeMap* treemap_create(int(*compare)(void*,void*), void* pool);
+
+/**
+ * Destroy the TreeMap.
+ *
+ * @param treemap TreeMap
+ */
+void treemap_destroy(TreeMap* treemap);
+
+/**
+ * Check the TreeMap is empty or not.
+ *
+ * @param treemap TreeMap
+ * @return true if the TreeMap is empty
+ */
+bool treemap_is_empty(TreeMap* treemap);
+
+/**
+ * Put an element to the TreeMap.
+ *
+ * @param treemap TreeMap
+ * @param key key of element
+ * @param data data of element
+ * @return true if the element is putted, false if there is an element with same key or memory is full
+ */
+bool treemap_put(TreeMap* treemap, void* key, void* data);
+
+/**
+ * Update an element with new key and data.
+ *
+ * @param treemap TreeMap
+ * @param key new key of the element, it must be equal to the old key by the comparing function
+ * @param data new data of the element
+ * @return true if the element is updated, false if there is no such element
+ */
+bool treemap_update(TreeMap* treemap, void* key, void* data);
+
+/**
+ * Get an element data from the TreeMap.
+ *
+ * @param treemap TreeMap
+ * @param key key of the element
+ * @return the element's data or NULL if there is no such element
+ */
+void* treemap_get(TreeMap* treemap, void* key);
+
+/**
+ * Check there is an element.
+ *
+ * @param treemap TreeMap
+ * @param key key of the element
+ * @return true if there is an element with the key
+ */
+bool treemap_contains(TreeMap* treemap, void* key);
+
+/**
+ * Remove an element from the TreeMap.
+ *
+ * @param treemap TreeMap
+ * @param key key of the element
+ * @return removed element or NULL if nothing is removed
+ */
+void* treemap_remove(TreeMap* treemap, void* key);
+
+/**
+ * Find the element with the greatest key less than or equal to the key.
+ *
+ * @param treemap TreeMap
+ * @param key key to find
+ * @param entry the element found is stored
+ * @return true if there is such element
+ */
+bool treemap_floor(TreeMap* treemap, void* key, TreeMapEntry* entry);
+
+/**
+ * Find the element with the least key greater than or equal to the key.
+ *
+ * @param treemap TreeMap
+ * @param key key to find
+ * @param entry the element found is stored
+ * @return true if there is such element
+ */
+bool treemap_ceiling(TreeMap* treemap, void* key, TreeMapEntry* entry);
+
+/**
+ * Get the number of elements of the TreeMap.
+ *
+ * @param treemap TreeMap
+ * @return number of elements
+ */
+size_t treemap_size(TreeMap* treemap);
+
+/**
+ * Iterator of a TreeMap. Elements are iterated in key order.
+ * The iterator is not valid anymore once the TreeMap is modified.
+ */
+typedef struct _TreeMapIterator {
+	TreeMap*	treemap;	///< TreeMap (internal use only)
+	TreeMapLeaf*	leaf;		///< Current leaf (internal use only)
+	size_t		index;		///< Current index of leaf (internal use only)
+	void*		to;		///< Upper bound key (internal use only)
+	bool		bounded;	///< Upper bound key is used (internal use only)
+	TreeMapEntry	entry;		///< Temporary TreeMapEntry
+} TreeMapIterator;
+
+/**
+ * Initialize the iterator to iterate all elements.
+ *
+ * @param iter the iterator
+ * @param treemap TreeMap
+ */
+void treemap_iterator_init(TreeMapIterator* iter, TreeMap* treemap);
+
+/**
+ * Initialize the iterator to iterate elements from the first key not less than the key.
+ *
+ * @param iter the iterator
+ * @param treemap TreeMap
+ * @param key lower bound key
+ */
+void treemap_iterator_lower_bound(TreeMapIterator* iter, TreeMap* treemap, void* key);
+
+/**
+ * Initialize the iterator to iterate elements whose key is in [from, to).
+ *
+ * @param iter the iterator
+ * @param treemap TreeMap
+ * @param from lower bound key, inclusive
+ * @param to upper bound key, exclusive
+ */
+void treemap_iterator_range(TreeMapIterator* iter, TreeMap* treemap, void* from, void* to);
+
+/**
+ * Check there is more element to iterate.
+ *
+ * @param iter iterator
+ * @return true if there is more element to iterate
+ */
+bool treemap_iterator_has_next(TreeMapIterator* iter);
+
+/**
+ * Get next element from iterator.
+ *
+ * @param iter iterator
+ * @return next element (TreeMapEntry) or NULL if there is no more element
+ */
+TreeMapEntry* treemap_iterator_next(TreeMapIterator* iter);
+
+/**
+ * unsigned integer 64-bits comparing function
+ *
+ * @param key1 key of an element
+ * @param key2 key of another element
+ * @return negative, zero or positive value if key1 is less than, equal to or greater than key2
+ */
+int treemap_uint64_compare(void* key1, void* key2);
+
+/**
+ * C string comparing function
+ *
+ * @param key1 key of an element
+ * @param key2 key of another element
+ * @return negative, zero or positive value if key1 is less than, equal to or greater than key2
+ */
+int treemap_string_compare(void* key1, void* key2);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UTIL_TREEMAP_H__ */
@@ -0,0 +1,178 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "vector.h"
+#include "tvector.h"
+
+#define ELEMENT(tvector, index)	((tvector)->array + (index) * (tvector)->element_size)
+
+static bool reallocate(TypedVector* tvector, size_t size) {
+	char* array = realloc(tvector->array, tvector->element_size * size);
+	if(!array)
+		return false;
+
+	tvector->array = array;
+	tvector->size = size;
+	return true;
+}
+
+static bool grow(TypedVector* tvector, size_t required) {
+	if(required <= tvector->size)
+		return true;
+
+	size_t size = tvector->growth(tvector->size, required);
+	if(size < required)
+		size = required;
+
+	return reallocate(tvector, size);
+}
+
+TypedVector* tvector_create(size_t element_size, size_t size, void* pool) {
+	TypedVector* tvector = malloc(sizeof(TypedVector));
+	if(!tvector)
+		return NULL;
+
+	void* array = malloc(size * element_size);
+	if(!array) {
+		free(tvector);
+		return NULL;
+	}
+	tvector_init(tvector, array, element_size, size);
+	tvector->pool = pool;
+
+	return tvector;
+}
+
+void tvector_destroy(TypedVector* tvector) {
+	free(tvector->array);
+	free(tvector);
+}
+
+void tvector_init(TypedVector* tvector, void* array, size_t element_size, size_t size) {
+	tvector->index = 0;
+	tvector->size = size;
+	tvector->element_size = element_size;
+	tvector->array = array;
+	tvector->growth = vector_growth_default;
+	tvector->pool = NULL;
+}
+
+void tvector_set_growth(TypedVector* tvector, size_t(*growth)(size_t size, size_t required)) {
+	tvector->growth = growth ? growth : vector_growth_default;
+}
+
+bool tvector_reserve(TypedVector* tvector, size_t capacity) {
+	if(capacity <= tvector->size)
+		return true;
+
+	return reallocate(tvector, capacity);
+}
+
+bool tvector_available(TypedVector* tvector) {
+	return tvector->index < tvector->size;
+}
+
+bool tvector_is_empty(TypedVector* tvector) {
+	return tvector->index == 0;
+}
+
+bool tvector_add(TypedVector* tvector, const void* element) {
+	// element may point into the array, which moves when it grows
+	uintptr_t offset = (uintptr_t)element - (uintptr_t)tvector->array;
+	bool inside = offset < tvector->index * tvector->element_size;
+
+	void* slot = tvector_add_slot(tvector);
+	if(!slot)
+		return false;
+
+	memcpy(slot, inside ? tvector->array + offset : element, tvector->element_size);
+	return true;
+}
+
+void* tvector_add_slot(TypedVector* tvector) {
+	if(tvector->index >= tvector->size && !grow(tvector, tvector->index + 1))
+		return NULL;
+
+	return ELEMENT(tvector, tvector->index++);
+}
+
+void* tvector_get(TypedVector* tvector, size_t index) {
+	if(index >= tvector->index)
+		return NULL;
+	else
+		return ELEMENT(tvector, index);
+}
+
+void* tvector_get_last(TypedVector* tvector) {
+	if(tvector->index == 0)
+		return NULL;
+	else
+		return ELEMENT(tvector, tvector->index - 1);
+}
+
+bool tvector_remove(TypedVector* tvector, size_t index, void* element) {
+	if(index >= tvector->index)
+		return false;
+
+	if(element)
+		memcpy(element, ELEMENT(tvector, index), tvector->element_size);
+
+	tvector->index--;
+	memmove(ELEMENT(tvector, index), ELEMENT(tvector, index + 1), tvector->element_size * (tvector->index - index));
+	return true;
+}
+
+bool tvector_remove_last(TypedVector* tvector, void* element) {
+	if(tvector->index == 0)
+		return false;
+
+	tvector->index--;
+	if(element)
+		memcpy(element, ELEMENT(tvector, tvector->index), tvector->element_size);
+	return true;
+}
+
+bool tvector_swap_remove(TypedVector* tvector, size_t index, void* element) {
+	if(index >= tvector->index)
+		return false;
+
+	if(element)
+		memcpy(element, ELEMENT(tvector, index), tvector->element_size);
+
+	tvector->index--;
+	if(index != tvector->index)
+		memcpy(ELEMENT(tvector, index), ELEMENT(tvector, tvector->index), tvector->element_size);
+	return true;
+}
+
+size_t tvector_size(TypedVector* tvector) {
+	return tvector->index;
+}
+
+size_t tvector_capacity(TypedVector* tvector) {
+	return tvector->size;
+}
+
+void tvector_iterator_init(TypedVectorIterator* iter, TypedVector* tvector) {
+	iter->tvector = tvector;
+	iter->index = 0;
+}
+
+bool tvector_iterator_has_next(TypedVectorIterator* iter) {
+	return iter->index < iter->tvector->index;
+}
+
+void* tvector_iterator_next(TypedVectorIterator* iter) {
+	if(iter->index < iter->tvector->index)
+		return ELEMENT(iter->tvector, iter->index++);
+	else
+		return NULL;
+}
+
+bool tvector_iterator_remove(TypedVectorIterator* iter, void* element) {
+	if(iter->index == 0)
+		return false;
+
+	return tvector_remove(iter->tvector, --iter->index, element);
+}
@@ -0,0 +1,225 @@
+#ifndef __UTIL_TVECTOR_H__
+#define __UTIL_TVECTOR_H__
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @file
+ * Array wrapper data structure which stores elements inline
+ *
+ * Unlike Vector which holds pointers, TypedVector copies each element into
+ * the array itself, so small structs need no allocation of their own and
+ * iterating does not dereference a pointer per element.
+ */
+
+/**
+ * Typed Vector data structure
+ */
+typedef struct _TypedVector {
+	size_t		index;		///< Element index (internal use only)
+	size_t		size;		///< Array size in elements (internal use only)
+	size_t		element_size;	///< Size of an element in bytes (internal use only)
+	char*		array;		///< Array itself (internal use only)
+	size_t		(*growth)(size_t size, size_t required);	///< Growth policy (internal use only)
+	void*		pool;		///< Memory pool (internal use only)
+} TypedVector;
+
+/**
+ * Create a TypedVector of the type.
+ */
+#define TVECTOR_CREATE(type, size, pool)	tvector_create(sizeof(type), (size), (pool))
+
+/**
+ * Get a pointer to an element of the type, NULL if index is out of bounds.
+ */
+#define TVECTOR_GET(tvector, type, index)	((type*)tvector_get((tvector), (index)))
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Create a TypedVector. tvector_init will be called internally.
+ *
+ * @param element_size size of an element in bytes
+ * @param size number of elements to allocate
+ * @param pool memory pool to use, if NULL local memory area will be used
+ */
+TypedVector* tvector_create(size_t element_size, size_t size, void* pool);
+
+/**
+ * Destroy the TypedVector.
+ *
+ * @param tvector TypedVector
+ */
+void tvector_destroy(TypedVector* tvector);
+
+/**
+ * Initialize the TypedVector which is not created using tvector_create function.
+ *
+ * @param tvector TypedVector
+ * @param array array to use, it must be allocated with malloc as it is reallocated on growth
+ * @param element_size size of an element in bytes
+ * @param size number of elements the array can hold
+ */
+void tvector_init(TypedVector* tvector, void* array, size_t element_size, size_t size);
+
+/**
+ * Set the growth policy. See vector_set_growth.
+ *
+ * @param tvector TypedVector
+ * @param growth growth policy, if NULL vector_growth_default will be used
+ */
+void tvector_set_growth(TypedVector* tvector, size_t(*growth)(size_t size, size_t required));
+
+/**
+ * Make sure the TypedVector can hold the number of elements without growing.
+ *
+ * @param tvector TypedVector
+ * @param capacity number of elements to hold
+ * @return false if there is no more memory to allocate
+ */
+bool tvector_reserve(TypedVector* tvector, size_t capacity);
+
+/**
+ * Check there is available space to add an element.
+ *
+ * @param tvector TypedVector
+ * @return true if there is available space
+ */
+bool tvector_available(TypedVector* tvector);
+
+/**
+ * Check the TypedVector is empty or not.
+ *
+ * @param tvector TypedVector
+ * @return true if the TypedVector is empty
+ */
+bool tvector_is_empty(TypedVector* tvector);
+
+/**
+ * Add an element to the TypedVector by copying it.
+ *
+ * @param tvector TypedVector
+ * @param element pointer to the element to copy
+ * @return true if the element is added
+ */
+bool tvector_add(TypedVector* tvector, const void* element);
+
+/**
+ * Add an uninitialized element to the TypedVector to be filled in place.
+ *
+ * @param tvector TypedVector
+ * @return pointer to the new element or NULL if there is no more memory to allocate
+ */
+void* tvector_add_slot(TypedVector* tvector);
+
+/**
+ * Get an element from the TypedVector.
+ *
+ * @param tvector TypedVector
+ * @param index element index
+ * @return pointer to the element or NULL if index is out of bounds. It is valid until the TypedVector grows.
+ */
+void* tvector_get(TypedVector* tvector, size_t index);
+
+/**
+ * Get last element from the TypedVector.
+ *
+ * @param tvector TypedVector
+ * @return pointer to the last element or NULL if there is no element
+ */
+void* tvector_get_last(TypedVector* tvector);
+
+/**
+ * Remove an element from the TypedVector.
+ *
+ * @param tvector TypedVector
+ * @param index index of the element
+ * @param element buffer to copy the removed element, can be NULL
+ * @return true if the element is removed
+ */
+bool tvector_remove(TypedVector* tvector, size_t index, void* element);
+
+/**
+ * Remove last element from the TypedVector.
+ *
+ * @param tvector TypedVector
+ * @param element buffer to copy the removed element, can be NULL
+ * @return true if the element is removed
+ */
+bool tvector_remove_last(TypedVector* tvector, void* element);
+
+/**
+ * Remove an element by moving the last element into its place. The order is not kept.
+ *
+ * @param tvector TypedVector
+ * @param index index of the element
+ * @param element buffer to copy the removed element, can be NULL
+ * @return true if the element is removed
+ */
+bool tvector_swap_remove(TypedVector* tvector, size_t index, void* element);
+
+/**
+ * Get the number of elements of the TypedVector.
+ *
+ * @param tvector TypedVector
+ * @return size of the TypedVector
+ */
+size_t tvector_size(TypedVector* tvector);
+
+/**
+ * Get the capacity of the TypedVector.
+ *
+ * @param tvector TypedVector
+ * @return capacity size of the TypedVector
+ */
+size_t tvector_capacity(TypedVector* tvector);
+
+/**
+ * Iterator of a TypedVector.
+ */
+typedef struct _TypedVectorIterator {
+	TypedVector* tvector;		///< TypedVector (internal use only)
+	size_t index;			///< current position (internal use only)
+} TypedVectorIterator;
+
+/**
+ * Initialize the iterator.
+ *
+ * @param iter the iterator
+ * @param tvector TypedVector
+ */
+void tvector_iterator_init(TypedVectorIterator* iter, TypedVector* tvector);
+
+/**
+ * Check there is more element to iterate.
+ *
+ * @param iter iterator
+ * @return true if there is more element to iterate
+ */
+bool tvector_iterator_has_next(TypedVectorIterator* iter);
+
+/**
+ * Get next element from iterator.
+ *
+ * @param iter iterator
+ * @return pointer to the next element
+ */
+void* tvector_iterator_next(TypedVectorIterator* iter);
+
+/**
+ * Remove the element from the TypedVector which is recently iterated using tvector_iterator_next function.
+ *
+ * @param iter iterator
+ * @param element buffer to copy the removed element, can be NULL
+ * @return true if the element is removed
+ */
+bool tvector_iterator_remove(TypedVectorIterator* iter, void* element);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UTIL_TVECTOR_H__ */
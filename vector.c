@@ -1,7 +1,74 @@
+#define _GNU_SOURCE
 #include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
 #include "vector.h"
 
+static size_t map_length(size_t size) {
+	size_t page = sysconf(_SC_PAGESIZE);
+	size_t length = (size * sizeof(void*) + page - 1) / page * page;
+
+	return length ? length : page;
+}
+
+// Big arrays move to mmap so that growing them remaps pages instead of copying
+static bool reallocate(Vector* vector, size_t size) {
+	void** array;
+	if(vector->mapped) {
+		size_t length = map_length(size);
+		array = mremap(vector->array, map_length(vector->size), length, MREMAP_MAYMOVE);
+		if(array == MAP_FAILED)
+			return false;
+
+		size = length / sizeof(void*);
+	} else if(size * sizeof(void*) >= VECTOR_MREMAP_THRESHOLD) {
+		size_t length = map_length(size);
+		array = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if(array == MAP_FAILED)
+			return false;
+
+		memcpy(array, vector->array, sizeof(void*) * vector->index);
+		if(!vector->embedded)
+			free(vector->array);
+		vector->mapped = true;
+		size = length / sizeof(void*);
+	} else if(vector->embedded) {
+		// The inline array can not be reallocated, it spills to the heap only when growing
+		if(size <= vector->size)
+			return true;
+
+		array = malloc(sizeof(void*) * size);
+		if(!array)
+			return false;
+
+		memcpy(array, vector->array, sizeof(void*) * vector->index);
+	} else {
+		array = realloc(vector->array, sizeof(void*) * size);
+		if(!array)
+			return false;
+	}
+
+	vector->array = array;
+	vector->size = size;
+	vector->embedded = false;
+	return true;
+}
+
+static bool grow(Vector* vector, size_t required) {
+	if(required <= vector->size)
+		return true;
+
+	size_t size = vector->growth(vector->size, required);
+	if(size < required)
+		size = required;
+
+	return reallocate(vector, size);
+}
+
 Vector* vector_create(size_t size, void* pool) {
 	Vector* vector = malloc(sizeof(Vector));
 	if(!vector)
@@ -18,8 +85,15 @@ Vector* vector_create(size_t size, void* pool) {
 	return vector;
 }
 
+static void release(Vector* vector) {
+	if(vector->mapped)
+		munmap(vector->array, map_length(vector->size));
+	else if(!vector->embedded)
+		free(vector->array);
+}
+
 void vector_destroy(Vector* vector) {
-	free(vector->array);
+	release(vector);
 	free(vector);
 }
 
@@ -27,9 +101,72 @@ void vector_init(Vector* vector, void** array, size_t size) {
 	vector->index = 0;
 	vector->size = size;
 	vector->array = array;
+	vector->growth = vector_growth_default;
+	vector->mapped = false;
+	vector->embedded = false;
 	vector->pool = NULL;
 }
 
+Vector* small_vector_create(void* pool) {
+	SmallVector* svector = malloc(sizeof(SmallVector));
+	if(!svector)
+		return NULL;
+
+	Vector* vector = small_vector_init(svector);
+	vector->pool = pool;
+
+	return vector;
+}
+
+Vector* small_vector_init(SmallVector* svector) {
+	Vector* vector = &svector->vector;
+	vector_init(vector, svector->inline_array, VECTOR_INLINE_SIZE);
+	vector->embedded = true;
+
+	return vector;
+}
+
+void small_vector_fini(Vector* vector) {
+	release(vector);
+	vector->embedded = true;
+	vector->mapped = false;
+	vector->array = ((SmallVector*)vector)->inline_array;
+	vector->size = VECTOR_INLINE_SIZE;
+	vector->index = 0;
+}
+
+void vector_set_growth(Vector* vector, size_t(*growth)(size_t size, size_t required)) {
+	vector->growth = growth ? growth : vector_growth_default;
+}
+
+size_t vector_growth_default(size_t size, size_t required) {
+	size = size + (size >> 1) + 1;
+	return size < required ? required : size;
+}
+
+size_t vector_growth_double(size_t size, size_t required) {
+	size = size ? size << 1 : 1;
+	return size < required ? required : size;
+}
+
+bool vector_reserve(Vector* vector, size_t capacity) {
+	if(capacity <= vector->size)
+		return true;
+
+	return reallocate(vector, capacity);
+}
+
+bool vector_resize(Vector* vector, size_t size) {
+	if(!grow(vector, size))
+		return false;
+
+	if(size > vector->index)
+		memset(&vector->array[vector->index], 0, sizeof(void*) * (size - vector->index));
+
+	vector->index = size;
+	return true;
+}
+
 bool vector_available(Vector* vector) {
 	return vector->index < vector->size;
 }
@@ -39,20 +176,59 @@ bool vector_is_empty(Vector* vector) {
 }
 
 bool vector_add(Vector* vector, void* data) {
-	if(vector->index >= vector->size) {
-		size_t new_size = (size_t) ((vector->size * 1.5) + 1);
-		void** array = realloc(vector->array, sizeof(void*) * new_size);
-		if (!array)
-			return false;
-
-		vector->array = array;
-		vector->size = new_size;
-	}
+	if(vector->index >= vector->size && !grow(vector, vector->index + 1))
+		return false;
 
 	vector->array[vector->index++] = data;
 	return true;
 }
 
+bool vector_add_all(Vector* vector, void** array, size_t count) {
+	if(count > SIZE_MAX - vector->index)
+		return false;
+
+	// array may point into the elements, which move when they grow
+	uintptr_t offset = (uintptr_t)array - (uintptr_t)vector->array;
+	bool inside = offset < vector->index * sizeof(void*);
+
+	if(!grow(vector, vector->index + count))
+		return false;
+
+	if(inside)
+		array = (void**)((uintptr_t)vector->array + offset);
+
+	memmove(&vector->array[vector->index], array, sizeof(void*) * count);
+	vector->index += count;
+	return true;
+}
+
+bool vector_insert_at(Vector* vector, size_t index, void** array, size_t count) {
+	if(index > vector->index || count > SIZE_MAX - vector->index)
+		return false;
+
+	uintptr_t offset = (uintptr_t)array - (uintptr_t)vector->array;
+	bool inside = offset < vector->index * sizeof(void*);
+
+	if(!grow(vector, vector->index + count))
+		return false;
+
+	memmove(&vector->array[index + count], &vector->array[index], sizeof(void*) * (vector->index - index));
+	if(inside) {
+		// Elements of array before index stay, the rest were moved back by count
+		size_t source = offset / sizeof(void*);
+		size_t before = source < index ? index - source : 0;
+		if(before > count)
+			before = count;
+
+		memcpy(&vector->array[index], &vector->array[source], sizeof(void*) * before);
+		memcpy(&vector->array[index + before], &vector->array[source + before + count], sizeof(void*) * (count - before));
+	} else {
+		memcpy(&vector->array[index], array, sizeof(void*) * count);
+	}
+	vector->index += count;
+	return true;
+}
+
 void* vector_get(Vector* vector, size_t index) {
 	if(index >= vector->index)
 		return NULL;
@@ -61,13 +237,8 @@ void* vector_get(Vector* vector, size_t index) {
 }
 
 bool vector_pack(Vector* vector) {
-	void** array = realloc(vector->array, sizeof(void*) * vector->index);
-	if (!array)
-		return false;
-
-	vector->array = array;
-	vector->size = vector->index;
-	return true;
+	// realloc to 0 bytes would free the array, an empty Vector keeps a slot
+	return reallocate(vector, vector->index ? vector->index : 1);
 }
 
 void* vector_remove_last(Vector* vector) {
@@ -84,13 +255,77 @@ void* vector_get_last(Vector* vector) {
 		return vector->array[vector->index - 1];
 }
 
-static bool default_comp_fn(void* v1, void* v2) {
-	return v1 == v2;
+static size_t find_pointer_scalar(void** array, size_t index, size_t count, void* data) {
+	for(; index < count; index++)
+		if(array[index] == data)
+			return index;
+
+	return -1;
+}
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+
+// 8 pointers per round, two pointers per SSE2 register
+static size_t find_pointer_sse2(void** array, size_t count, void* data) {
+	__m128i key = _mm_set1_epi64x((int64_t)(intptr_t)data);
+	size_t index = 0;
+	for(; index + 8 <= count; index += 8) {
+		int mask = 0;
+		for(int i = 0; i < 4; i++) {
+			__m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128((__m128i*)&array[index + i * 2]), key);
+			// Both 32-bit halves must match
+			eq = _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+			mask |= _mm_movemask_pd(_mm_castsi128_pd(eq)) << (i * 2);
+		}
+
+		if(mask)
+			return index + __builtin_ctz(mask);
+	}
+
+	return find_pointer_scalar(array, index, count, data);
+}
+
+// 8 pointers per round, four pointers per AVX2 register
+__attribute__((target("avx2")))
+static size_t find_pointer_avx2(void** array, size_t count, void* data) {
+	__m256i key = _mm256_set1_epi64x((int64_t)(intptr_t)data);
+	size_t index = 0;
+	for(; index + 8 <= count; index += 8) {
+		__m256i eq0 = _mm256_cmpeq_epi64(_mm256_loadu_si256((__m256i*)&array[index]), key);
+		__m256i eq1 = _mm256_cmpeq_epi64(_mm256_loadu_si256((__m256i*)&array[index + 4]), key);
+		int mask = _mm256_movemask_pd(_mm256_castsi256_pd(eq0)) | _mm256_movemask_pd(_mm256_castsi256_pd(eq1)) << 4;
+
+		if(mask)
+			return index + __builtin_ctz(mask);
+	}
+
+	return find_pointer_scalar(array, index, count, data);
+}
+
+static bool force_sse2;
+
+static size_t find_pointer(void** array, size_t count, void* data) {
+	if(!force_sse2 && __builtin_cpu_supports("avx2"))
+		return find_pointer_avx2(array, count, data);
+	else
+		return find_pointer_sse2(array, count, data);
+}
+#else
+static bool force_sse2;
+
+static size_t find_pointer(void** array, size_t count, void* data) {
+	return find_pointer_scalar(array, 0, count, data);
+}
+#endif
+
+void vector_force_sse2(bool force) {
+	force_sse2 = force;
 }
 
 size_t vector_index_of(Vector* vector, void* data, bool(*comp_fn)(void*,void*)) {
 	if(!comp_fn)
-		comp_fn = default_comp_fn;
+		return find_pointer(vector->array, vector->index, data);
 	
 	for(size_t index = 0; index < vector->index; index++)
 		if(comp_fn(vector->array[index], data))
@@ -99,6 +334,210 @@ size_t vector_index_of(Vector* vector, void* data, bool(*comp_fn)(void*,void*))
 	return -1;
 }
 
+static int default_order_fn(void* v1, void* v2) {
+	uintptr_t p1 = (uintptr_t)v1;
+	uintptr_t p2 = (uintptr_t)v2;
+
+	return p1 < p2 ? -1 : p1 > p2;
+}
+
+// default_order_fn on the array slots, for plain qsort without the qsort_r trampoline
+static int default_qsort_fn(const void* v1, const void* v2) {
+	uintptr_t p1 = *(const uintptr_t*)v1;
+	uintptr_t p2 = *(const uintptr_t*)v2;
+
+	return p1 < p2 ? -1 : p1 > p2;
+}
+
+typedef struct {
+	int(*comp_fn)(void*,void*);
+	void** src;
+	void** dst;
+	size_t begin;
+	size_t middle;
+	size_t end;
+} SortTask;
+
+static int sort_comp(const void* v1, const void* v2, void* arg) {
+	return ((SortTask*)arg)->comp_fn(*(void**)v1, *(void**)v2);
+}
+
+static void* sort_run(void* arg) {
+	SortTask* task = arg;
+	qsort_r(task->src + task->begin, task->end - task->begin, sizeof(void*), sort_comp, task);
+
+	return NULL;
+}
+
+static void* merge_runs(void* arg) {
+	SortTask* task = arg;
+	size_t i = task->begin;
+	size_t j = task->middle;
+	size_t k = task->begin;
+
+	while(i < task->middle && j < task->end) {
+		if(task->comp_fn(task->src[j], task->src[i]) < 0)
+			task->dst[k++] = task->src[j++];
+		else
+			task->dst[k++] = task->src[i++];
+	}
+
+	memcpy(&task->dst[k], &task->src[i], sizeof(void*) * (task->middle - i));
+	k += task->middle - i;
+	memcpy(&task->dst[k], &task->src[j], sizeof(void*) * (task->end - j));
+
+	return NULL;
+}
+
+// Run every task, one per thread, falling back to the calling thread
+static void run_parallel(void*(*fn)(void*), SortTask* tasks, pthread_t* threads, size_t count) {
+	bool started[count];
+	for(size_t i = 1; i < count; i++)
+		started[i] = pthread_create(&threads[i], NULL, fn, &tasks[i]) == 0;
+
+	fn(&tasks[0]);
+
+	for(size_t i = 1; i < count; i++) {
+		if(started[i])
+			pthread_join(threads[i], NULL);
+		else
+			fn(&tasks[i]);
+	}
+}
+
+void vector_sort(Vector* vector, int(*comp_fn)(void*,void*), size_t threads) {
+	size_t count = vector->index;
+	if(threads == 0) {
+		long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		threads = cpus > 0 ? cpus : 1;
+	}
+
+	if(threads > count / (VECTOR_SORT_PARALLEL_THRESHOLD / 2))
+		threads = count / (VECTOR_SORT_PARALLEL_THRESHOLD / 2);
+
+	// A single thread sorts in place, without the run and merge machinery
+	if(count < VECTOR_SORT_PARALLEL_THRESHOLD || threads <= 1) {
+		if(!comp_fn) {
+			qsort(vector->array, count, sizeof(void*), default_qsort_fn);
+		} else {
+			SortTask task = { .comp_fn = comp_fn };
+			qsort_r(vector->array, count, sizeof(void*), sort_comp, &task);
+		}
+		return;
+	}
+
+	if(!comp_fn)
+		comp_fn = default_order_fn;
+
+	void** tmp = malloc(sizeof(void*) * count);
+	SortTask* tasks = malloc(sizeof(SortTask) * threads);
+	pthread_t* ids = malloc(sizeof(pthread_t) * threads);
+	if(!tmp || !tasks || !ids) {
+		SortTask task = { .comp_fn = comp_fn };
+		qsort_r(vector->array, count, sizeof(void*), sort_comp, &task);
+
+		free(tmp);
+		free(tasks);
+		free(ids);
+		return;
+	}
+
+	// Sort one run per thread
+	size_t runs = threads;
+	size_t bounds[runs + 1];
+	for(size_t i = 0; i <= runs; i++)
+		bounds[i] = count * i / runs;
+
+	for(size_t i = 0; i < runs; i++) {
+		tasks[i].comp_fn = comp_fn;
+		tasks[i].src = vector->array;
+		tasks[i].begin = bounds[i];
+		tasks[i].end = bounds[i + 1];
+	}
+	run_parallel(sort_run, tasks, ids, runs);
+
+	// Merge pairs of runs until one run is left
+	void** src = vector->array;
+	void** dst = tmp;
+	while(runs > 1) {
+		size_t pairs = runs / 2;
+		for(size_t i = 0; i < pairs; i++) {
+			tasks[i].comp_fn = comp_fn;
+			tasks[i].src = src;
+			tasks[i].dst = dst;
+			tasks[i].begin = bounds[i * 2];
+			tasks[i].middle = bounds[i * 2 + 1];
+			tasks[i].end = bounds[i * 2 + 2];
+		}
+		run_parallel(merge_runs, tasks, ids, pairs);
+
+		if(runs % 2)
+			memcpy(&dst[bounds[runs - 1]], &src[bounds[runs - 1]], sizeof(void*) * (bounds[runs] - bounds[runs - 1]));
+
+		for(size_t i = 0; i <= pairs; i++)
+			bounds[i] = bounds[i * 2 < runs ? i * 2 : runs];
+		runs = runs - pairs;
+		bounds[runs] = count;
+
+		void** swap = src;
+		src = dst;
+		dst = swap;
+	}
+
+	if(src != vector->array)
+		memcpy(vector->array, src, sizeof(void*) * count);
+
+	free(tmp);
+	free(tasks);
+	free(ids);
+}
+
+size_t vector_lower_bound(Vector* vector, void* data, int(*comp_fn)(void*,void*)) {
+	if(!comp_fn)
+		comp_fn = default_order_fn;
+
+	size_t low = 0;
+	size_t high = vector->index;
+	while(low < high) {
+		size_t middle = low + (high - low) / 2;
+		if(comp_fn(vector->array[middle], data) < 0)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	return low;
+}
+
+size_t vector_bsearch(Vector* vector, void* data, int(*comp_fn)(void*,void*)) {
+	if(!comp_fn)
+		comp_fn = default_order_fn;
+
+	size_t index = vector_lower_bound(vector, data, comp_fn);
+	if(index < vector->index && comp_fn(vector->array[index], data) == 0)
+		return index;
+
+	return -1;
+}
+
+bool vector_add_sorted(Vector* vector, void* data, int(*comp_fn)(void*,void*)) {
+	if(!comp_fn)
+		comp_fn = default_order_fn;
+
+	// Upper bound, so that equal elements stay in insertion order
+	size_t low = 0;
+	size_t high = vector->index;
+	while(low < high) {
+		size_t middle = low + (high - low) / 2;
+		if(comp_fn(data, vector->array[middle]) < 0)
+			high = middle;
+		else
+			low = middle + 1;
+	}
+
+	return vector_insert_at(vector, low, &data, 1);
+}
+
 void* vector_remove(Vector* vector, size_t index) {
 	if(index >= vector->index) {
 		return NULL;
@@ -106,15 +545,33 @@ void* vector_remove(Vector* vector, size_t index) {
 		void* data = vector->array[index];
 		vector->index--;
 		
-		while(index < vector->index) {
-			vector->array[index] = vector->array[index + 1];
-			index++;
-		}
+		memmove(&vector->array[index], &vector->array[index + 1], sizeof(void*) * (vector->index - index));
 		
 		return data;
 	}
 }
 
+size_t vector_remove_range(Vector* vector, size_t index, size_t count) {
+	if(index >= vector->index)
+		return 0;
+
+	if(count > vector->index - index)
+		count = vector->index - index;
+
+	memmove(&vector->array[index], &vector->array[index + count], sizeof(void*) * (vector->index - index - count));
+	vector->index -= count;
+	return count;
+}
+
+void* vector_swap_remove(Vector* vector, size_t index) {
+	if(index >= vector->index)
+		return NULL;
+
+	void* data = vector->array[index];
+	vector->array[index] = vector->array[--vector->index];
+	return data;
+}
+
 size_t vector_size(Vector* vector) {
 	return vector->index;
 }
@@ -9,6 +9,20 @@
  * Array wrapper data structure
  */
 
+/**
+ * Arrays of at least this many bytes are allocated with mmap and grown with mremap
+ */
+#ifndef VECTOR_MREMAP_THRESHOLD
+#define VECTOR_MREMAP_THRESHOLD	(4 * 1024 * 1024)
+#endif
+
+/**
+ * Number of elements SmallVector holds without allocating
+ */
+#ifndef VECTOR_INLINE_SIZE
+#define VECTOR_INLINE_SIZE	8
+#endif
+
 /**
  * Vector (or array) data structure
  */
@@ -16,9 +30,27 @@ typedef struct _Vector {
 	size_t		index;	///< Element index (internal use only)
 	size_t		size;	///< Array size (internal use only)
 	void**		array;	///< Array itself (internal use only)
+	size_t		(*growth)(size_t size, size_t required);	///< Growth policy (internal use only)
+	bool		mapped;	///< Array is allocated with mmap (internal use only)
+	bool		embedded;	///< Array is the inline array of SmallVector (internal use only)
 	void*		pool;	///< Memory pool (internal use only)
 } Vector;
 
+/**
+ * Vector which keeps the first VECTOR_INLINE_SIZE elements in itself and
+ * moves them to the heap only when it grows beyond that.
+ */
+typedef struct _SmallVector {
+	Vector		vector;	///< Vector (internal use only)
+	void*		inline_array[VECTOR_INLINE_SIZE];	///< Inline array (internal use only)
+} SmallVector;
+
+/**
+ * Declare a SmallVector on the stack and a Vector pointer named name to use it.
+ * small_vector_fini must be called before it goes out of scope.
+ */
+#define SMALL_VECTOR(name)	SmallVector name##_storage; Vector* name = small_vector_init(&name##_storage)
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -47,6 +79,73 @@ void vector_destroy(Vector* vector);
  */
 void vector_init(Vector* vector, void** array, size_t size);
 
+/**
+ * Create a SmallVector with a single allocation. It is destroyed with vector_destroy.
+ *
+ * @param pool memory pool to use, if NULL local memory area will be used
+ * @return Vector of the SmallVector
+ */
+Vector* small_vector_create(void* pool);
+
+/**
+ * Initialize the SmallVector which is not created using small_vector_create function, e.g. on the stack.
+ *
+ * @param svector SmallVector
+ * @return Vector of the SmallVector
+ */
+Vector* small_vector_init(SmallVector* svector);
+
+/**
+ * Release the array of the SmallVector if it has grown to the heap and make it empty.
+ *
+ * @param vector Vector of the SmallVector
+ */
+void small_vector_fini(Vector* vector);
+
+/**
+ * Set the growth policy which decides the new array size when the Vector is full.
+ *
+ * @param vector Vector
+ * @param growth function returning the new array size from the current size and the required size, if NULL vector_growth_default will be used
+ */
+void vector_set_growth(Vector* vector, size_t(*growth)(size_t size, size_t required));
+
+/**
+ * Default growth policy, grows by half of the current size.
+ *
+ * @param size current array size
+ * @param required minimum array size needed
+ * @return new array size
+ */
+size_t vector_growth_default(size_t size, size_t required);
+
+/**
+ * Growth policy which doubles the current size.
+ *
+ * @param size current array size
+ * @param required minimum array size needed
+ * @return new array size
+ */
+size_t vector_growth_double(size_t size, size_t required);
+
+/**
+ * Make sure the Vector can hold the number of elements without growing.
+ *
+ * @param vector Vector
+ * @param capacity number of elements to hold
+ * @return false if there is no more memory to allocate
+ */
+bool vector_reserve(Vector* vector, size_t capacity);
+
+/**
+ * Change the number of elements. New elements are set to NULL.
+ *
+ * @param vector Vector
+ * @param size the new number of elements
+ * @return false if there is no more memory to allocate
+ */
+bool vector_resize(Vector* vector, size_t size);
+
 /**
  * Check there is available space to add an element.
  *
@@ -72,6 +171,27 @@ bool vector_is_empty(Vector* vector);
  */
 bool vector_add(Vector* vector, void* data);
 
+/**
+ * Add many elements to the end of the Vector.
+ *
+ * @param vector Vector
+ * @param array elements to add, they may be elements of the Vector itself
+ * @param count number of elements
+ * @return true if every element is added, nothing is added otherwise
+ */
+bool vector_add_all(Vector* vector, void** array, size_t count);
+
+/**
+ * Insert many elements at the index, following elements are moved back.
+ *
+ * @param vector Vector
+ * @param index index to insert, it must not exceed the number of elements
+ * @param array elements to insert, they may be elements of the Vector itself
+ * @param count number of elements
+ * @return true if every element is inserted, nothing is inserted otherwise
+ */
+bool vector_insert_at(Vector* vector, size_t index, void** array, size_t count);
+
 /**
  * Get an element from the Vector.
  *
@@ -111,6 +231,61 @@ void* vector_get_last(Vector* vector);
  */
 size_t vector_index_of(Vector* vector, void* data, bool(*comp_fn)(void*,void*));
 
+/**
+ * Make vector_index_of use SSE2 even if AVX2 is available, so that both paths
+ * can be tested on one machine (internal use only). No effect outside x86-64.
+ *
+ * @param force true to use SSE2 only
+ */
+void vector_force_sse2(bool force);
+
+/**
+ * Vectors with at least this many elements are sorted by multiple threads
+ */
+#ifndef VECTOR_SORT_PARALLEL_THRESHOLD
+#define VECTOR_SORT_PARALLEL_THRESHOLD	65536
+#endif
+
+/**
+ * Sort the Vector. Large Vectors are split into runs which are sorted and
+ * merged by multiple threads.
+ *
+ * @param vector Vector
+ * @param comp_fn ordering function returning negative, zero or positive like strcmp, if NULL pointer values are compared
+ * @param threads maximum number of threads to use, zero means the number of online CPUs
+ */
+void vector_sort(Vector* vector, int(*comp_fn)(void*,void*), size_t threads);
+
+/**
+ * Find an element in the sorted Vector using binary search.
+ *
+ * @param vector Vector sorted with the same comp_fn
+ * @param data the element to find
+ * @param comp_fn ordering function, if NULL pointer values are compared
+ * @return index of a matching element, -1 if nothing is matched
+ */
+size_t vector_bsearch(Vector* vector, void* data, int(*comp_fn)(void*,void*));
+
+/**
+ * Find the first element which is not less than data in the sorted Vector.
+ *
+ * @param vector Vector sorted with the same comp_fn
+ * @param data the element to compare
+ * @param comp_fn ordering function, if NULL pointer values are compared
+ * @return index of the element, the number of elements if every element is less than data
+ */
+size_t vector_lower_bound(Vector* vector, void* data, int(*comp_fn)(void*,void*));
+
+/**
+ * Add an element to the sorted Vector keeping the order. Equal elements keep insertion order.
+ *
+ * @param vector Vector sorted with the same comp_fn
+ * @param data an element to add
+ * @param comp_fn ordering function, if NULL pointer values are compared
+ * @return true if the element is added
+ */
+bool vector_add_sorted(Vector* vector, void* data, int(*comp_fn)(void*,void*));
+
 /**
  * Remove an element from the Vector.
  *
@@ -120,6 +295,25 @@ size_t vector_index_of(Vector* vector, void* data, bool(*comp_fn)(void*,void*));
  */
 void* vector_remove(Vector* vector, size_t index);
 
+/**
+ * Remove a range of elements from the Vector.
+ *
+ * @param vector Vector
+ * @param index index of the first element
+ * @param count number of elements to remove
+ * @return number of removed elements, less than count if the range exceeds the Vector
+ */
+size_t vector_remove_range(Vector* vector, size_t index, size_t count);
+
+/**
+ * Remove an element by moving the last element into its place. The order is not kept.
+ *
+ * @param vector Vector
+ * @param index index of the element
+ * @return removed element or NULL if nothing is removed
+ */
+void* vector_swap_remove(Vector* vector, size_t index);
+
 /**
  * Get the number of elements of the Vector.
  *
@@ -0,0 +1,159 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include "wsdeque.h"
+
+// Chase-Lev deque with the C11 memory orderings of Le et al., PPoPP'13
+
+static WSDequeArray* array_create(size_t size) {
+	WSDequeArray* array = malloc(sizeof(WSDequeArray) + size * sizeof(void*));
+	if(!array)
+		return NULL;
+
+	array->next = NULL;
+	array->size = size;
+
+	return array;
+}
+
+static inline void* array_get(WSDequeArray* array, int64_t index) {
+	return __atomic_load_n(&array->array[index & (array->size - 1)], __ATOMIC_RELAXED);
+}
+
+static inline void array_set(WSDequeArray* array, int64_t index, void* data) {
+	__atomic_store_n(&array->array[index & (array->size - 1)], data, __ATOMIC_RELAXED);
+}
+
+// Thieves may still read the old array, so it is kept until the deque is destroyed
+static WSDequeArray* grow(WSDeque* deque, WSDequeArray* array, int64_t top, int64_t bottom) {
+	WSDequeArray* array2 = array_create(array->size * 2);
+	if(!array2)
+		return NULL;
+
+	for(int64_t i = top; i < bottom; i++)
+		array_set(array2, i, array_get(array, i));
+
+	array->next = deque->retired;
+	deque->retired = array;
+	__atomic_store_n(&deque->array, array2, __ATOMIC_RELEASE);
+
+	return array2;
+}
+
+WSDeque* wsdeque_create(size_t size, void* pool) {
+	WSDeque* deque;
+	if(posix_memalign((void**)&deque, 64, sizeof(WSDeque)))
+		return NULL;
+
+	if(!wsdeque_init(deque, size)) {
+		free(deque);
+		return NULL;
+	}
+	deque->pool = pool;
+
+	return deque;
+}
+
+void wsdeque_destroy(WSDeque* deque) {
+	wsdeque_fini(deque);
+	free(deque);
+}
+
+bool wsdeque_init(WSDeque* deque, size_t size) {
+	size_t size2 = 1;
+	while(size2 < size)
+		size2 <<= 1;
+
+	// The array is always allocated as it is retired and freed on growth
+	deque->array = array_create(size2);
+	if(!deque->array)
+		return false;
+
+	deque->top = 0;
+	deque->bottom = 0;
+	deque->retired = NULL;
+	deque->pool = NULL;
+
+	return true;
+}
+
+void wsdeque_fini(WSDeque* deque) {
+	WSDequeArray* array = deque->retired;
+	while(array) {
+		WSDequeArray* next = array->next;
+		free(array);
+		array = next;
+	}
+
+	free(deque->array);
+	deque->array = NULL;
+	deque->retired = NULL;
+}
+
+bool wsdeque_push(WSDeque* deque, void* data) {
+	int64_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED);
+	int64_t top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+	WSDequeArray* array = __atomic_load_n(&deque->array, __ATOMIC_RELAXED);
+
+	if(bottom - top > (int64_t)array->size - 1) {
+		array = grow(deque, array, top, bottom);
+		if(!array)
+			return false;
+	}
+
+	array_set(array, bottom, data);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	__atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+
+	return true;
+}
+
+void* wsdeque_pop(WSDeque* deque) {
+	int64_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED) - 1;
+	WSDequeArray* array = __atomic_load_n(&deque->array, __ATOMIC_RELAXED);
+	__atomic_store_n(&deque->bottom, bottom, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	int64_t top = __atomic_load_n(&deque->top, __ATOMIC_RELAXED);
+
+	if(top > bottom) {
+		__atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+		return NULL;
+	}
+
+	void* data = array_get(array, bottom);
+	if(top == bottom) {
+		// Last element, race against thieves
+		if(!__atomic_compare_exchange_n(&deque->top, &top, top + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+			data = NULL;
+
+		__atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+	}
+
+	return data;
+}
+
+void* wsdeque_steal(WSDeque* deque) {
+	int64_t top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	int64_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_ACQUIRE);
+
+	if(top >= bottom)
+		return NULL;
+
+	WSDequeArray* array = __atomic_load_n(&deque->array, __ATOMIC_ACQUIRE);
+	void* data = array_get(array, top);
+	if(!__atomic_compare_exchange_n(&deque->top, &top, top + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+		return NULL;
+
+	return data;
+}
+
+size_t wsdeque_size(WSDeque* deque) {
+	int64_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED);
+	int64_t top = __atomic_load_n(&deque->top, __ATOMIC_RELAXED);
+
+	return bottom > top ? bottom - top : 0;
+}
+
+bool wsdeque_empty(WSDeque* deque) {
+	return wsdeque_size(deque) == 0;
+}
@@ -0,0 +1,117 @@
+#ifndef __UTIL_WSDEQUE_H__
+#define __UTIL_WSDEQUE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @file
+ * Work-stealing deque data structure (Chase-Lev)
+ *
+ * The owner thread pushes and pops at the bottom, any other thread may steal
+ * from the top concurrently. The circular array grows when it is full.
+ */
+
+/**
+ * Circular array of the work-stealing deque (internal use only)
+ */
+typedef struct _WSDequeArray {
+	struct _WSDequeArray*	next;		///< Retired arrays chain
+	size_t			size;		///< Array size, power of two
+	void*			array[];	///< Elements
+} WSDequeArray;
+
+/**
+ * Work-stealing deque data structure
+ */
+typedef struct _WSDeque {
+	int64_t		top __attribute__((aligned(64)));	///< Steal index (internal use only)
+	int64_t		bottom __attribute__((aligned(64)));	///< Owner index (internal use only)
+	WSDequeArray*	array;		///< Current array (internal use only)
+	WSDequeArray*	retired;	///< Arrays replaced by growing (internal use only)
+	void*		pool;		///< Memory pool (internal use only)
+} WSDeque;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Create a WSDeque. wsdeque_init will be called internally.
+ *
+ * @param size initial array size, it will be rounded up to power of two
+ * @param pool memory pool, if NULL local memory area will be used
+ * @return WSDeque
+ */
+WSDeque* wsdeque_create(size_t size, void* pool);
+
+/**
+ * Destroy the WSDeque. No thread may be using it.
+ */
+void wsdeque_destroy(WSDeque* deque);
+
+/**
+ * Initialize the WSDeque which is not created using wsdeque_create function.
+ * The deque must be aligned to 64 bytes, which the WSDeque type already
+ * requires. The circular array is still allocated, as growing frees it.
+ *
+ * @param deque WSDeque
+ * @param size initial array size, it will be rounded up to power of two
+ * @return false if there is no memory for the array
+ */
+bool wsdeque_init(WSDeque* deque, size_t size);
+
+/**
+ * Release the arrays of the WSDeque initialized by wsdeque_init. No thread may be using it.
+ *
+ * @param deque WSDeque
+ */
+void wsdeque_fini(WSDeque* deque);
+
+/**
+ * Push an element to the bottom. Owner thread only.
+ *
+ * @param deque WSDeque
+ * @param data an element to push
+ * @return false if the array is full and there is no more memory to grow it
+ */
+bool wsdeque_push(WSDeque* deque, void* data);
+
+/**
+ * Pop an element from the bottom. Owner thread only.
+ *
+ * @param deque WSDeque
+ * @return popped element or NULL if there is no element
+ */
+void* wsdeque_pop(WSDeque* deque);
+
+/**
+ * Steal an element from the top. Any thread.
+ *
+ * @param deque WSDeque
+ * @return stolen element or NULL if there is no element or another thread won the race
+ */
+void* wsdeque_steal(WSDeque* deque);
+
+/**
+ * Get the number of elements. The value is a snapshot when other threads are stealing.
+ *
+ * @param deque WSDeque
+ * @return number of elements
+ */
+size_t wsdeque_size(WSDeque* deque);
+
+/**
+ * Check WSDeque is empty or not
+ *
+ * @param deque WSDeque
+ * @return true if WSDeque is empty
+ */
+bool wsdeque_empty(WSDeque* deque);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UTIL_WSDEQUE_H__ */